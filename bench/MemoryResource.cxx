@@ -0,0 +1,165 @@
+#include <MemoryResource.hxx>
+
+#include <map>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <memory_resource>
+
+namespace
+{
+	using pool_type = Seweex::Memory::Pool<65536, alignof(std::max_align_t)>;
+
+	constexpr size_t rounds  = 20;
+	constexpr size_t threads = 4;
+	constexpr size_t samples = 5;
+
+	struct Workload final
+	{
+		char const* name;
+		size_t		(*run) (std::pmr::memory_resource&);
+	};
+
+	size_t vector_growth(std::pmr::memory_resource& resource)
+	{
+		constexpr size_t count = size_t{ 1 } << 16;
+
+		for (size_t round = 0; round < rounds; ++round) {
+			std::pmr::vector<int> values{ &resource };
+
+			for (size_t i = 0; i < count; ++i)
+				values.push_back(static_cast<int>(i));
+		}
+
+		return rounds * count;
+	}
+
+	size_t map_churn(std::pmr::memory_resource& resource)
+	{
+		constexpr size_t count = 20000;
+
+		std::mt19937 random{ 1 };
+
+		for (size_t round = 0; round < rounds; ++round) {
+			std::pmr::map<unsigned, unsigned> values{ &resource };
+
+			for (size_t i = 0; i < count; ++i)
+				values.emplace(random(), static_cast<unsigned>(i));
+
+			while (!values.empty())
+				values.erase(values.begin());
+		}
+
+		return rounds * count * 2;
+	}
+
+	size_t string_churn(std::pmr::memory_resource& resource)
+	{
+		constexpr size_t live  = 4096;
+		constexpr size_t count = 200000;
+
+		std::mt19937 random{ 2 };
+		std::pmr::vector<std::pmr::string> strings{ live, &resource };
+
+		for (size_t i = 0; i < count; ++i)
+			strings[random() % live].assign(16 + random() % 240, 'x');
+
+		return count;
+	}
+
+	size_t threaded_mixed(std::pmr::memory_resource& resource)
+	{
+		constexpr size_t live  = 1024;
+		constexpr size_t count = 200000;
+
+		std::vector<std::jthread> workers;
+
+		for (size_t worker = 0; worker < threads; ++worker)
+			workers.emplace_back([&resource, worker]
+			{
+				struct Block final
+				{
+					void*  data  = nullptr;
+					size_t bytes = 0;
+				};
+
+				std::mt19937	   random{ static_cast<unsigned>(worker) };
+				std::vector<Block> blocks (live);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					auto& block = blocks[random() % live];
+
+					if (block.data != nullptr)
+						resource.deallocate(block.data, block.bytes);
+
+					block.bytes = 8 + random() % 1024;
+					block.data	= resource.allocate(block.bytes);
+				}
+
+				for (auto const& block : blocks)
+					if (block.data != nullptr)
+						resource.deallocate(block.data, block.bytes);
+			});
+
+		workers.clear();
+		return threads * count;
+	}
+
+	_NODISCARD double measure(Workload const& workload, std::pmr::memory_resource& resource)
+	{
+		auto const started = std::chrono::steady_clock::now();
+		auto const ops	   = workload.run(resource);
+
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count() / ops;
+	}
+
+	// Every sample gets a fresh resource, the median keeps one noisy run from deciding the result
+	template <class _MakeTy>
+	_NODISCARD double median(Workload const& workload, _MakeTy const& make)
+	{
+		std::array<double, samples> results;
+
+		for (auto& result : results)
+			result = make([&workload] (std::pmr::memory_resource& resource) {
+				return measure(workload, resource);
+			});
+
+		std::nth_element(results.begin(), results.begin() + samples / 2, results.end());
+		return results[samples / 2];
+	}
+}
+
+int main()
+{
+	constexpr Workload workloads[] = {
+		{ "vector growth",			 &vector_growth  },
+		{ "map churn",				 &map_churn		 },
+		{ "string churn",			 &string_churn	 },
+		{ "threaded mixed sizes x4", &threaded_mixed }
+	};
+
+	std::printf("%-24s %14s %14s %9s\n", "workload", "pool ns/op", "sync ns/op", "speedup");
+
+	for (auto const& workload : workloads)
+	{
+		auto const pooled = median(workload, [] (auto const& run) {
+			pool_type pool;
+			Seweex::Memory::PoolResource resource{ pool };
+
+			return run(resource);
+		});
+
+		auto const synchronized = median(workload, [] (auto const& run) {
+			std::pmr::synchronized_pool_resource resource;
+			return run(resource);
+		});
+
+		std::printf("%-24s %14.1f %14.1f %8.2fx\n", workload.name, pooled, synchronized, synchronized / pooled);
+	}
+}
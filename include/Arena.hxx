@@ -0,0 +1,233 @@
+#ifndef SEWEEX_MEMORY_ARENA
+#define SEWEEX_MEMORY_ARENA
+
+#include "Memory.hxx"
+
+#include <span>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace Seweex
+{
+	namespace Detail
+	{
+		inline constexpr size_t arena_batch = 64;
+
+		struct ArenaBlock final
+		{
+			ArenaBlock* prev;
+			size_t		size;
+		};
+	}
+
+	namespace Memory
+	{
+		template <class _PoolTy>
+		class Arena final
+		{
+			static constexpr size_t header_size = (sizeof(Detail::ArenaBlock) + alignof(std::max_align_t) - 1) &
+												  ~(alignof(std::max_align_t) - 1);
+
+			_NODISCARD void* occupy_slow(size_t bytes, size_t alignment) noexcept
+			{
+				if (bytes > std::numeric_limits<size_t>::max() - header_size - alignment)
+					return nullptr;
+
+				auto const size = std::max(_PoolTy::page_size, header_size + bytes + alignment);
+				void*	   data = nullptr;
+
+				if (size == _PoolTy::page_size && mySpare != nullptr)
+					data = std::exchange(mySpare, nullptr);
+				else
+					data = myPool->template occupy<std::byte>(size, Occupy::Bounded<>{});
+
+				if (data == nullptr)
+					return nullptr;
+
+				myHead = ::new (data) Detail::ArenaBlock{ myHead, size };
+
+				myCursor = reinterpret_cast<uintptr_t>(data) + header_size;
+				myEnd	 = reinterpret_cast<uintptr_t>(data) + size;
+
+				return occupy(bytes, alignment);
+			}
+
+			// Blocks go back through release_batch, so the pool lock is taken once per batch rather than once per block
+			void drop_until(Detail::ArenaBlock* marker, bool keepSpare) noexcept
+			{
+				std::array<std::pair<void*, size_t>, Detail::arena_batch> batch;
+				size_t size = 0;
+
+				auto const drop = [this, &batch, &size] (Detail::ArenaBlock* block) noexcept 
+				{
+					batch[size++] = { block, block->size };
+
+					if (size == batch.size())
+						myPool->release_batch(std::span{ batch.data(), std::exchange(size, 0) });
+				};
+
+				while (myHead != marker)
+				{
+					auto const block = std::exchange(myHead, myHead->prev);
+
+					if (keepSpare && block->size == _PoolTy::page_size && mySpare == nullptr)
+						mySpare = block;
+					else
+						drop(block);
+				}
+
+				if (!keepSpare && mySpare != nullptr)
+					drop(std::exchange(mySpare, nullptr));
+
+				if (size != 0)
+					myPool->release_batch(std::span{ batch.data(), size });
+			}
+
+		public:
+			using pool_type = _PoolTy;
+
+			class Marker final
+			{
+			private:
+				friend class Arena;
+
+				constexpr Marker (
+					Detail::ArenaBlock* head,
+					uintptr_t			cursor,
+					uintptr_t			end
+				) noexcept :
+					myHead	 (head),
+					myCursor (cursor),
+					myEnd	 (end)
+				{}
+
+			public:
+				constexpr Marker() noexcept = default;
+
+			private:
+				Detail::ArenaBlock* myHead	 = nullptr;
+				uintptr_t			myCursor = 0;
+				uintptr_t			myEnd	 = 0;
+			};
+
+			class Scope final
+			{
+			public:
+				Scope (Arena& arena) noexcept :
+					myArena  (arena),
+					myMarker (arena.checkpoint())
+				{}
+
+				Scope(Scope&&)		= delete;
+				Scope(Scope const&) = delete;
+
+				Scope& operator=(Scope&&)      = delete;
+				Scope& operator=(Scope const&) = delete;
+
+				~Scope() noexcept {
+					myArena.rewind(myMarker);
+				}
+
+			private:
+				Arena& myArena;
+				Marker myMarker;
+			};
+
+			Arena (pool_type& pool) noexcept :
+				myPool (std::addressof(pool))
+			{}
+
+			Arena (Arena&& other) noexcept :
+				myPool	 (other.myPool),
+				myHead	 (std::exchange(other.myHead, nullptr)),
+				mySpare	 (std::exchange(other.mySpare, nullptr)),
+				myCursor (std::exchange(other.myCursor, 0)),
+				myEnd	 (std::exchange(other.myEnd, 0))
+			{}
+
+			Arena(Arena const&) = delete;
+
+			Arena& operator=(Arena&& other) noexcept
+			{
+				if (this != std::addressof(other)) {
+					reset();
+
+					myPool	 = other.myPool;
+					myHead	 = std::exchange(other.myHead, nullptr);
+					mySpare	 = std::exchange(other.mySpare, nullptr);
+					myCursor = std::exchange(other.myCursor, 0);
+					myEnd	 = std::exchange(other.myEnd, 0);
+				}
+
+				return *this;
+			}
+
+			Arena& operator=(Arena const&) = delete;
+
+			~Arena() noexcept {
+				reset();
+			}
+
+			// Without a block the empty range at zero would hand out a null pointer for a zero sized request
+			_NODISCARD void* occupy(size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept
+			{
+				assert(std::has_single_bit(alignment) && "arena alignments must be powers of two");
+
+				auto const aligned = (myCursor + alignment - 1) & ~(alignment - 1);
+
+				if (myHead != nullptr && aligned <= myEnd && bytes <= myEnd - aligned) {
+					myCursor = aligned + bytes;
+					return reinterpret_cast<void*>(aligned);
+				}
+
+				return occupy_slow(bytes, alignment);
+			}
+
+			template <class _Ty>
+			_NODISCARD _Ty* occupy(size_t count) noexcept
+			{
+				if (count > std::numeric_limits<size_t>::max() / sizeof(_Ty))
+					return nullptr;
+
+				return static_cast<_Ty*>(occupy(sizeof(_Ty) * count, alignof(_Ty)));
+			}
+
+			_NODISCARD Marker checkpoint() const noexcept {
+				return { myHead, myCursor, myEnd };
+			}
+
+			void rewind(Marker const& marker) noexcept
+			{
+				drop_until(marker.myHead, true);
+
+				myCursor = marker.myCursor;
+				myEnd	 = marker.myEnd;
+			}
+
+			// Every block and the spare go back at once
+			void reset() noexcept
+			{
+				drop_until(nullptr, false);
+
+				myCursor = 0;
+				myEnd	 = 0;
+			}
+
+			_NODISCARD pool_type& pool() const noexcept {
+				return *myPool;
+			}
+
+		private:
+			pool_type*			myPool;
+			Detail::ArenaBlock* myHead  = nullptr;
+			Detail::ArenaBlock* mySpare = nullptr;
+
+			uintptr_t myCursor = 0;
+			uintptr_t myEnd	   = 0;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef SEWEEX_MEMORY_ASYNC_OCCUPY
+#define SEWEEX_MEMORY_ASYNC_OCCUPY
+
+#include "Memory.hxx"
+
+#include <chrono>
+#include <optional>
+#include <coroutine>
+#include <stop_token>
+
+namespace Seweex
+{
+	namespace Detail
+	{
+		template <class _Ty>
+		concept Executor = requires (_Ty& _val, std::coroutine_handle<> handle) {
+			{ _val.execute(handle) };
+		};
+	}
+
+	namespace Memory
+	{
+		struct InlineExecutor final
+		{
+			void execute(std::coroutine_handle<> handle) const {
+				handle.resume();
+			}
+		};
+
+		template <class _Ty, class _PoolTy, Detail::Executor _ExecutorTy = InlineExecutor>
+		class OccupyAwaiter final : private Detail::OccupyWaiter
+		{
+			struct Cancel final
+			{
+				OccupyAwaiter* self;
+
+				void operator()() const noexcept {
+					self->myPool->cancel(*self);
+				}
+			};
+
+			void resume() noexcept override {
+				myExecutor.execute(myHandle);
+			}
+
+		public:
+			using pool_type		= _PoolTy;
+			using executor_type = _ExecutorTy;
+			using clock_type	= std::chrono::steady_clock;
+
+			OccupyAwaiter (
+				pool_type&				pool,
+				size_t					bytes,
+				size_t					alignment,
+				std::stop_token			token	 = {},
+				clock_type::time_point	deadline = clock_type::time_point::max(),
+				executor_type			executor = {}
+			) noexcept :
+				Detail::OccupyWaiter (bytes, alignment, deadline),
+				myPool		(std::addressof(pool)),
+				myToken		(std::move(token)),
+				myExecutor	(std::move(executor))
+			{}
+
+			OccupyAwaiter(OccupyAwaiter&&)	    = delete;
+			OccupyAwaiter(OccupyAwaiter const&) = delete;
+
+			OccupyAwaiter& operator=(OccupyAwaiter&&)      = delete;
+			OccupyAwaiter& operator=(OccupyAwaiter const&) = delete;
+
+			_NODISCARD bool await_ready() noexcept
+			{
+				if (myToken.stop_requested() || !std::has_single_bit(alignment))
+					return true;
+
+				return (result = myPool->occupy_bytes(bytes, alignment)) != nullptr;
+			}
+
+			// Nothing of this awaiter may be touched once it is queued, another thread can resume the coroutine at any moment
+			_NODISCARD bool await_suspend(std::coroutine_handle<> handle) noexcept
+			{
+				myHandle = handle;
+				myCallback.emplace(myToken, Cancel{ this });
+
+				return myPool->enqueue(*this);
+			}
+
+			_NODISCARD _Ty* await_resume() noexcept
+			{
+				myCallback.reset();
+				return static_cast<_Ty*>(result);
+			}
+
+		private:
+			pool_type*				myPool;
+			std::stop_token			myToken;
+			std::coroutine_handle<> myHandle;
+
+			[[no_unique_address]] executor_type myExecutor;
+
+			std::optional<std::stop_callback<Cancel>> myCallback;
+		};
+
+		template <class _Ty, class _PoolTy, Detail::Executor _ExecutorTy = InlineExecutor>
+		_NODISCARD OccupyAwaiter<_Ty, _PoolTy, _ExecutorTy> async_occupy (
+			_PoolTy&							  pool,
+			size_t								  count,
+			std::stop_token						  token	   = {},
+			std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+			_ExecutorTy							  executor = {}
+		) noexcept {
+			// A zero alignment is never satisfied, so an overflowing count completes at once with nullptr
+			if (count > std::numeric_limits<size_t>::max() / sizeof(_Ty))
+				return { pool, 0, 0, std::move(token), deadline, std::move(executor) };
+
+			return { pool, sizeof(_Ty) * count, alignof(_Ty), std::move(token), deadline, std::move(executor) };
+		}
+
+		template <class _PoolTy, Detail::Executor _ExecutorTy = InlineExecutor>
+		_NODISCARD OccupyAwaiter<void, _PoolTy, _ExecutorTy> async_occupy_bytes (
+			_PoolTy&							  pool,
+			size_t								  bytes,
+			size_t								  alignment,
+			std::stop_token						  token	   = {},
+			std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+			_ExecutorTy							  executor = {}
+		) noexcept {
+			return { pool, bytes, alignment, std::move(token), deadline, std::move(executor) };
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,288 @@
+#ifndef SEWEEX_MEMORY_HUGE_PAGES
+#define SEWEEX_MEMORY_HUGE_PAGES
+
+#include "Memory.hxx"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Seweex
+{
+	namespace Detail
+	{
+		// Huge pages are counted in the kernel's page size, pool pages by the backing of the storage they live in
+		struct HugePageUsage final
+		{
+			size_t hugetlb_pages	 = 0;
+			size_t transparent_pages = 0;
+
+			size_t hugetlb_pool_pages	  = 0;
+			size_t transparent_pool_pages = 0;
+			size_t advised_pool_pages	  = 0;
+			size_t regular_pool_pages	  = 0;
+		};
+
+		inline constexpr size_t transparent_huge_page = size_t{ 1 } << 21;
+
+		// Pool chunks tell how many pool pages they hold, any other element counts as one page
+		template <class _Ty>
+		inline constexpr size_t pool_pages_in = 1;
+
+		template <class _Ty>
+		requires requires { { _Ty::page_count } -> std::convertible_to<size_t>; }
+		inline constexpr size_t pool_pages_in<_Ty> = _Ty::page_count;
+
+		class HugePageRegistry final
+		{
+		public:
+			enum class Backing {
+				hugetlb,
+				transparent,
+				regular
+			};
+
+		private:
+			struct Region final
+			{
+				size_t  length;
+				size_t  pages;
+				size_t  huge_size;
+				Backing backing;
+			};
+
+			_NODISCARD static size_t backed_bytes(uintptr_t begin, uintptr_t end, std::string const& smaps) noexcept
+			{
+				std::istringstream stream{ smaps };
+				std::string line;
+
+				uintptr_t areaBegin = 0;
+				uintptr_t areaEnd   = 0;
+				size_t    result    = 0;
+
+				while (std::getline(stream, line))
+				{
+					unsigned long long first, last;
+					char dash;
+
+					if (line.rfind("AnonHugePages:", 0) == 0)
+					{
+						auto const overlapBegin = std::max(begin, areaBegin);
+						auto const overlapEnd   = std::min(end, areaEnd);
+
+						if (overlapBegin < overlapEnd)
+						{
+							auto const areaHuge = std::stoull(line.substr(sizeof("AnonHugePages:") - 1)) * 1024;
+							auto const areaSize = areaEnd - areaBegin;
+
+							result += static_cast<size_t>(
+								static_cast<long double>(areaHuge) * (overlapEnd - overlapBegin) / areaSize);
+						}
+					}
+					else if (std::istringstream{ line } >> std::hex >> first >> dash >> last && dash == '-') {
+						areaBegin = static_cast<uintptr_t>(first);
+						areaEnd   = static_cast<uintptr_t>(last);
+					}
+				}
+
+				return result;
+			}
+
+		public:
+			_NODISCARD void* map(size_t bytes, size_t alignment, size_t pages, size_t hugeSize) noexcept
+			{
+				auto  length  = (bytes + Detail::system_page_size() - 1) & ~(Detail::system_page_size() - 1);
+				auto  backing = Backing::regular;
+				void* data    = nullptr;
+
+				auto const hugeLength = (bytes + hugeSize - 1) & ~(hugeSize - 1);
+
+				if (hugeLength - bytes <= hugeLength / 8)
+				{
+					auto const hugeFlags = static_cast<int>(std::countr_zero(hugeSize)) << MAP_HUGE_SHIFT;
+
+					data = Detail::map_memory(hugeLength, std::max(alignment, hugeSize), MAP_HUGETLB | hugeFlags, hugeSize);
+
+					if (data != nullptr) {
+						length  = hugeLength;
+						backing = Backing::hugetlb;
+					}
+					else if (data = Detail::map_memory(hugeLength, std::max(alignment, hugeSize)); data)
+					{
+						length  = hugeLength;
+						backing = madvise(data, length, MADV_HUGEPAGE) == 0 ?
+								  Backing::transparent :
+								  Backing::regular;
+					}
+				}
+
+				if (data == nullptr)
+					data = Detail::map_memory(length, alignment);
+
+				if (data != nullptr)
+				{
+					std::lock_guard lock{ myMutex };
+					myRegions.emplace(reinterpret_cast<uintptr_t>(data), Region{ length, pages, hugeSize, backing });
+				}
+
+				return data;
+			}
+
+			void unmap(void* data) noexcept
+			{
+				size_t length = 0;
+
+				{
+					std::lock_guard lock{ myMutex };
+					auto const iter = myRegions.find(reinterpret_cast<uintptr_t>(data));
+
+					if (iter != myRegions.end()) {
+						length = iter->second.length;
+						myRegions.erase(iter);
+					}
+				}
+
+				if (length != 0)
+					Detail::unmap_memory(data, length, 0);
+			}
+
+			_NODISCARD HugePageUsage usage() const
+			{
+				HugePageUsage result;
+				std::string smaps;
+
+				std::lock_guard lock{ myMutex };
+
+				for (auto const& [begin, region] : myRegions)
+				{
+					switch (region.backing)
+					{
+					case Backing::hugetlb:
+						result.hugetlb_pages	  += region.length / region.huge_size;
+						result.hugetlb_pool_pages += region.pages;
+						break;
+
+					case Backing::transparent:
+						if (smaps.empty()) {
+							std::ostringstream content;
+							content << std::ifstream{ "/proc/self/smaps" }.rdbuf();
+							smaps = std::move(content).str();
+						}
+
+						{
+							auto const backed = backed_bytes(begin, begin + region.length, smaps);
+							auto const pages  = region.pages * backed / region.length;
+
+							result.transparent_pages	  += backed / transparent_huge_page;
+							result.transparent_pool_pages += pages;
+							result.advised_pool_pages	  += region.pages - pages;
+						}
+						break;
+
+					case Backing::regular:
+						result.regular_pool_pages += region.pages;
+						break;
+					}
+				}
+
+				return result;
+			}
+
+		private:
+			mutable std::mutex myMutex;
+			std::map<uintptr_t, Region> myRegions;
+		};
+	}
+
+	namespace Memory
+	{
+		using HugePageUsage = Detail::HugePageUsage;
+
+		inline constexpr size_t huge_page_2m = size_t{ 1 } << 21;
+
+		// Larger than a 2 MiB Pool chunk, so Pool rejects it at compile time; it suits containers of a gigabyte or more
+		inline constexpr size_t huge_page_1g = size_t{ 1 } << 30;
+
+		template <class _Ty, size_t _HugePageSize = huge_page_2m>
+		requires (std::has_single_bit(_HugePageSize))
+		class HugePageAllocator
+		{
+			template <class, size_t _OtherSize>
+			requires (std::has_single_bit(_OtherSize))
+			friend class HugePageAllocator;
+
+			_NODISCARD static bool is_small(size_t count) noexcept {
+				return sizeof(_Ty) * count < Detail::system_page_size();
+			}
+
+		public:
+			using value_type = _Ty;
+
+			static constexpr size_t huge_page_size = _HugePageSize;
+
+			template <class _OtherTy>
+			struct rebind final {
+				using other = HugePageAllocator<_OtherTy, _HugePageSize>;
+			};
+
+			HugePageAllocator() :
+				myRegistry (std::make_shared<Detail::HugePageRegistry>())
+			{}
+
+			template <class _OtherTy>
+			HugePageAllocator(HugePageAllocator<_OtherTy, _HugePageSize> const& other) noexcept :
+				myRegistry (other.myRegistry)
+			{}
+
+			HugePageAllocator(HugePageAllocator&&)      noexcept = default;
+			HugePageAllocator(HugePageAllocator const&) noexcept = default;
+
+			HugePageAllocator& operator=(HugePageAllocator&&)      noexcept = default;
+			HugePageAllocator& operator=(HugePageAllocator const&) noexcept = default;
+
+			_NODISCARD _Ty* allocate(size_t count)
+			{
+				if (count > std::numeric_limits<size_t>::max() / sizeof(_Ty))
+					throw std::bad_array_new_length{};
+
+				if (is_small(count))
+					return static_cast<_Ty*>(::operator new(sizeof(_Ty) * count, std::align_val_t{ alignof(_Ty) }));
+
+				auto const data = myRegistry->map(sizeof(_Ty) * count, alignof(_Ty), count * Detail::pool_pages_in<_Ty>, _HugePageSize);
+
+				if (data == nullptr)
+					throw std::bad_alloc{};
+
+				return static_cast<_Ty*>(data);
+			}
+
+			void deallocate(_Ty* data, size_t count) noexcept 
+			{
+				if (is_small(count))
+					::operator delete(data, std::align_val_t{ alignof(_Ty) });
+				else
+					myRegistry->unmap(data);
+			}
+
+			_NODISCARD HugePageUsage usage() const {
+				return myRegistry->usage();
+			}
+
+			template <class _OtherTy>
+			_NODISCARD bool operator==(HugePageAllocator<_OtherTy, _HugePageSize> const& other) const noexcept {
+				return myRegistry == other.myRegistry;
+			}
+
+		private:
+			std::shared_ptr<Detail::HugePageRegistry> myRegistry;
+		};
+	}
+}
+
+#endif
@@ -2,21 +2,90 @@
 #define SEWEEX_MEMORY_POOL
 
 #include <bit>
+#include <concepts>
 #include <list>
 #include <map>
 #include <memory>
+#include <new>
+#include <cstring>
+#include <cstdint>
 #include <array>
 #include <limits>
 #include <thread>
+#include <condition_variable>
 #include <variant>
 #include <mutex>
 #include <atomic>
+#include <chrono>
 #include <shared_mutex>
+#include <deque>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <system_error>
+#include <algorithm>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#	include <fcntl.h>
+#	include <sched.h>
+#	include <unistd.h>
+#	include <sys/file.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <sys/syscall.h>
+#	include <linux/mempolicy.h>
+#endif
+
+#ifndef _NODISCARD
+#define _NODISCARD [[nodiscard]]
+#endif
+
+#if defined(SEWEEX_MEMORY_POOL_PROFILING) && __has_include(<execinfo.h>)
+#	include <cmath>
+#	include <execinfo.h>
+#	define SEWEEX_MEMORY_PROFILING 1
+#else
+#	define SEWEEX_MEMORY_PROFILING 0
+#endif
+
+#if defined(SEWEEX_MEMORY_POOL_TRACING) && __has_include(<sys/sdt.h>)
+#	ifndef _SDT_HAS_SEMAPHORES
+#		define _SDT_HAS_SEMAPHORES 1
+#	endif
+#	include <sys/sdt.h>
+#	define SEWEEX_MEMORY_PROBES 1
+#	define SEWEEX_MEMORY_PROBE_ENABLED(name) __builtin_expect(seweex_mempool_##name##_semaphore != 0, 0)
+#	define SEWEEX_MEMORY_PROBE(name, ...) \
+		do { if (!std::is_constant_evaluated() && SEWEEX_MEMORY_PROBE_ENABLED(name)) STAP_PROBEV(seweex_mempool, name, __VA_ARGS__); } while (false)
+
+// Tracers bump a probe's semaphore while attached, arguments are evaluated only then
+#	define SEWEEX_MEMORY_PROBE_SEMAPHORE(name) \
+		inline volatile unsigned short seweex_mempool_##name##_semaphore __attribute__((unused, section(".probes"))) = 0
+
+extern "C"
+{
+	SEWEEX_MEMORY_PROBE_SEMAPHORE(page_occupy);
+	SEWEEX_MEMORY_PROBE_SEMAPHORE(page_release);
+	SEWEEX_MEMORY_PROBE_SEMAPHORE(occupy);
+	SEWEEX_MEMORY_PROBE_SEMAPHORE(release);
+	SEWEEX_MEMORY_PROBE_SEMAPHORE(grow);
+	SEWEEX_MEMORY_PROBE_SEMAPHORE(trim);
+	SEWEEX_MEMORY_PROBE_SEMAPHORE(replenish);
+}
+#else
+#	define SEWEEX_MEMORY_PROBES 0
+#	define SEWEEX_MEMORY_PROBE_ENABLED(name) false
+#	define SEWEEX_MEMORY_PROBE(name, ...) static_cast<void>(0)
+#endif
 
 namespace Seweex
 {
 	namespace Detail
 	{
+		// Runs link to their predecessor by offset, so page metadata stays valid wherever the page is mapped
 		class PageBlockInfo final
 		{
 		public:
@@ -33,18 +102,18 @@ namespace Seweex
 			}
 			void remove_head() noexcept {
 				mySize = 0;
-				myPrev = nullptr;
+				myPrev = 0;
 			}
 
 			void prev(PageBlockInfo& info) noexcept {
-				myPrev = std::addressof(info);
+				myPrev = std::addressof(info) - this;
 			}
 			void prev(PageBlockInfo* info) noexcept {
-				myPrev = info;
+				myPrev = info != nullptr ? info - this : 0;
 			}
 
-			_NODISCARD PageBlockInfo* prev() const noexcept {
-				return myPrev;
+			_NODISCARD PageBlockInfo* prev() noexcept {
+				return myPrev != 0 ? this + myPrev : nullptr;
 			}
 
 			_NODISCARD size_t size() const noexcept {
@@ -56,8 +125,8 @@ namespace Seweex
 			}
 
 		private:
-			PageBlockInfo* myPrev = nullptr;
-			ptrdiff_t      mySize = 0;
+			ptrdiff_t myPrev = 0;
+			ptrdiff_t mySize = 0;
 		};
 
 		template <class _Ty>
@@ -71,369 +140,2573 @@ namespace Seweex
 
 			typename _Ty::value_type;
 		};
-	}
 
-	namespace Memory
-	{
-		template <size_t _Size, size_t _Alignment>
-		requires (
-			std::has_single_bit(_Alignment) &&
-			_Size % _Alignment == 0 &&
-			_Size > 0
-		)
-		class alignas(_Alignment) Page final
-		{
-			static constexpr size_t blocks_count = _Size / _Alignment;
+		template <class _Ty>
+		concept OccupyPolicy = requires {
+			{ _Ty::candidates } -> std::convertible_to<size_t>;
+			{ _Ty::growths }	-> std::convertible_to<size_t>;
+		};
 
-			using storage_type = std::array<unsigned char, _Size>;
-			using info_type    = std::array<Detail::PageBlockInfo, blocks_count>;
+		// Allocators that back their blocks with huge pages publish the page size, any other allocator has none
+		template <class _AllocTy>
+		inline constexpr size_t huge_page_size_of = 0;
 
-		public:
-			class Hint final
+		template <class _AllocTy>
+		requires requires { { _AllocTy::huge_page_size } -> std::convertible_to<size_t>; }
+		inline constexpr size_t huge_page_size_of<_AllocTy> = _AllocTy::huge_page_size;
+
+		_NODISCARD inline unsigned numa_nodes() noexcept
+		{
+			static unsigned const nodes = [] () noexcept -> unsigned
 			{
-			private:
-				friend class Page;
+#if defined(__linux__)
+				std::ifstream online{ "/sys/devices/system/node/online" };
+				unsigned last = 0;
+				unsigned node;
+				char	 separator;
 
-				using iterator = typename info_type::const_iterator;
+				while (online >> node) {
+					last = std::max(last, node);
 
-				constexpr Hint (
-					iterator iter,
-					iterator end
-				) noexcept :
-					myIter (iter),
-					myEnd  (end)
-				{}
+					if (!(online >> separator))
+						break;
+				}
 
-				constexpr Hint (iterator end) noexcept :
-					myIter (end),
-					myEnd  (end)
-				{}
+				return last + 1;
+#else
+				return 1;
+#endif
+			} ();
 
-			public:
-				constexpr Hint() noexcept = default;
+			return nodes;
+		}
 
-				constexpr Hint(Hint&&)      noexcept = default;
-				constexpr Hint(Hint const&) noexcept = default;
+		_NODISCARD inline unsigned numa_node() noexcept
+		{
+#if defined(__linux__)
+			unsigned cpu  = 0;
+			unsigned node = 0;
+
+#	if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+			if (getcpu(&cpu, &node) != 0)
+				return 0;
+#	else
+			if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+				return 0;
+#	endif
+			return node < numa_nodes() ? node : 0;
+#else
+			return 0;
+#endif
+		}
+
+		_NODISCARD inline size_t system_page_size() noexcept
+		{
+#if defined(__linux__)
+			static size_t const size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+			return size;
+#else
+			return 4096;
+#endif
+		}
+
+		_NODISCARD inline void* map_memory(
+			size_t length, 
+			size_t alignment, 
+			int	   flags	   = 0, 
+			size_t granularity = system_page_size()
+		) noexcept {
+#if defined(__linux__)
+			constexpr int protection = PROT_READ | PROT_WRITE;
+			constexpr int sharing	 = MAP_PRIVATE | MAP_ANONYMOUS;
+
+			if (alignment <= granularity) {
+				auto const data = mmap(nullptr, length, protection, sharing | flags, -1, 0);
+				return data != MAP_FAILED ? data : nullptr;
+			}
 
-				constexpr Hint& operator=(Hint&&)      noexcept = default;
-				constexpr Hint& operator=(Hint const&) noexcept = default;
+			auto const mapped = length + alignment - granularity;
+			auto const data   = mmap(nullptr, mapped, protection, sharing | flags, -1, 0);
 
-				_NODISCARD constexpr bool is_valid() const noexcept {
-					return std::holds_alternative<iterator>(myEnd) 
-						&& myIter != std::get<iterator>(myEnd);
-				}
+			if (data == MAP_FAILED)
+				return nullptr;
 
-				_NODISCARD constexpr bool is_valid(iterator const& trueEnd) const noexcept {
-					if (std::holds_alternative<iterator>(myEnd)) {
-						auto const& end = std::get<iterator>(myEnd);
-						return end == trueEnd && myIter != end;
-					}
-					else 
-						return false;
-				}
+			auto const begin   = reinterpret_cast<uintptr_t>(data);
+			auto const aligned = (begin + alignment - 1) & ~(alignment - 1);
+			auto const tail    = begin + mapped - (aligned + length);
 
-				_NODISCARD constexpr operator bool() const noexcept {
-					return is_valid();
-				}
+			if (aligned != begin)
+				munmap(data, aligned - begin);
 
-			private:
-				iterator myIter;
-				std::variant<std::monostate, iterator> myEnd;
-			};
+			if (tail != 0)
+				munmap(reinterpret_cast<void*>(aligned + length), tail);
 
-		private:
-			template <class _Ty>
-			_NODISCARD static constexpr size_t size_in_blocks(size_t count) noexcept {
-				return (sizeof(_Ty) * count + _Alignment - 1) & ~(_Alignment - 1);
-			}
+			return reinterpret_cast<void*>(aligned);
+#else
+			return flags == 0 ? ::operator new(length, std::align_val_t{ alignment }, std::nothrow) : nullptr;
+#endif
+		}
 
-			_NODISCARD constexpr typename info_type::iterator from_hint(Hint const& hint) noexcept 
-			{
-				return hint.is_valid(myInfo.cend()) ?
-					   myInfo.begin() + (hint.myIter - myInfo.cbegin()) :
-					   myInfo.end();
+		inline void unmap_memory(void* data, size_t length, [[maybe_unused]] size_t alignment) noexcept 
+		{
+#if defined(__linux__)
+			munmap(data, length);
+#else
+			::operator delete(data, std::align_val_t{ alignment });
+#endif
+		}
+
+		_NODISCARD inline void* remap_memory(void* data, size_t length, size_t newLength, size_t alignment) noexcept
+		{
+#if defined(__linux__)
+			if (alignment <= system_page_size()) {
+				auto const moved = mremap(data, length, newLength, MREMAP_MAYMOVE);
+				return moved != MAP_FAILED ? moved : nullptr;
 			}
+#endif
+			return nullptr;
+		}
 
+		// A file mapped shared over a reservation of its final length, only one process may hold it at a time
+		class MappedFile final
+		{
 		public:
-			constexpr Page() noexcept {
-				myInfo.front().make_head(true, blocks_count);
-			}
+			MappedFile() noexcept = default;
 
-			Page(Page&&)	  = delete;
-			Page(Page const&) = delete;
+			MappedFile (std::filesystem::path const& path)
+			{
+#if defined(__linux__)
+				myFile = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
 
-			Page& operator=(Page&&)      = delete;
-			Page& operator=(Page const&) = delete;
+				if (myFile < 0)
+					throw std::system_error{ errno, std::generic_category(), path.string() };
 
-			template <class _Ty>
-			_NODISCARD static constexpr float load_of(size_t count) noexcept {
-				constexpr float step = sizeof(_Ty) / static_cast<float>(_Size);
-				return step * count;
-			}
+				if (flock(myFile, LOCK_EX | LOCK_NB) != 0) {
+					auto const error = errno;
+					::close(std::exchange(myFile, -1));
 
-			_NODISCARD static constexpr float max_load() noexcept {
-				return 1;
+					throw std::system_error{ error, std::generic_category(), path.string() };
+				}
+#else
+				throw std::system_error{ std::make_error_code(std::errc::function_not_supported), path.string() };
+#endif
 			}
 
-			_NODISCARD float load() const noexcept {
-				return myLoad;
-			}
+			MappedFile(MappedFile&&)	  = delete;
+			MappedFile(MappedFile const&) = delete;
 
-			template <class _Ty>
-			_NODISCARD constexpr Hint fit(size_t count) const noexcept 
+			MappedFile& operator=(MappedFile&&)		 = delete;
+			MappedFile& operator=(MappedFile const&) = delete;
+
+			~MappedFile() noexcept
 			{
-				if constexpr (alignof(_Ty) <= _Alignment)
-				{
-					auto const blocks = size_in_blocks<_Ty>(count);
-					auto	   iter   = myInfo.begin();
+#if defined(__linux__)
+				if (myData != nullptr)
+					munmap(myData, myLength);
 
-					while (iter != myInfo.end()) {
-						auto const size = iter->size();
+				if (myFile >= 0)
+					::close(myFile);
+#endif
+			}
 
-						if (iter->is_free() && size >= blocks)
-							return { iter, myInfo.end() };
+			_NODISCARD size_t size() const noexcept
+			{
+#if defined(__linux__)
+				struct stat status{};
+				return fstat(myFile, &status) == 0 ? static_cast<size_t>(status.st_size) : 0;
+#else
+				return 0;
+#endif
+			}
 
-						iter += size;
-					}
-				}
-				
-				return { myInfo.end() };
+			_NODISCARD bool read(void* data, size_t bytes) const noexcept
+			{
+#if defined(__linux__)
+				return pread(myFile, data, bytes, 0) == static_cast<ssize_t>(bytes);
+#else
+				return false;
+#endif
 			}
 
-			template <class _Ty>
-			_NODISCARD constexpr Hint contains(_Ty* data, size_t count) const noexcept 
+			// Tries the preferred address first, the kernel picks an aligned one when it is taken
+			_NODISCARD std::byte* map(size_t length, size_t alignment, uintptr_t preferred)
 			{
-				if constexpr (alignof(_Ty) <= _Alignment)
+#if defined(__linux__)
+				constexpr int protection = PROT_READ | PROT_WRITE;
+#	if defined(MAP_FIXED_NOREPLACE)
+				constexpr int noReplace	 = MAP_FIXED_NOREPLACE;
+#	else
+				constexpr int noReplace	 = 0;
+#	endif
+				void* data = MAP_FAILED;
+
+				if (preferred != 0 && preferred % alignment == 0) 
 				{
-					auto const storageBegin = reinterpret_cast<uintptr_t>(myData.data());
-					auto const storageEnd   = storageBegin + _Size;
-
-					auto const dataBegin = reinterpret_cast<uintptr_t>(data);
-					auto const dataEnd   = reinterpret_cast<uintptr_t>(data + count);
-
-					if (dataBegin >= storageBegin && 
-						dataEnd <= storageEnd &&
-						dataBegin % _Alignment == 0
-					) {
-						auto const offset = (dataBegin - storageBegin) / _Alignment;
-						auto const blocks = size_in_blocks<_Ty>(count);
-						auto	   iter	  = myInfo.begin() + offset;
+					data = mmap(reinterpret_cast<void*>(preferred), length, protection, MAP_SHARED | noReplace, myFile, 0);
 
-						if (!iter->is_free() && iter->size() == blocks)
-							return { iter, myInfo.end() };
+					if (data != MAP_FAILED && data != reinterpret_cast<void*>(preferred)) {
+						munmap(data, length);
+						data = MAP_FAILED;
 					}
 				}
 
-				return { myInfo.end() };
-			}
-
-			template <class _Ty>
-			_NODISCARD constexpr _Ty* try_occupy(size_t count) noexcept {
-				return try_occupy<_Ty>(count, fit<_Ty>(count));
-			}
+				if (data == MAP_FAILED)
+				{
+					auto const reserved = map_memory(length, alignment, MAP_NORESERVE);
 
-			template <class _Ty>
-			_NODISCARD constexpr _Ty* try_occupy(size_t count, Hint const& hint) noexcept
-			{
-				auto const blocks = size_in_blocks<_Ty>(count);
-				auto	   iter   = from_hint(hint);
+					if (reserved == nullptr)
+						throw std::bad_alloc{};
 
-				if (iter != myInfo.end())
-				{
-					auto const size = iter->size();
+					data = mmap(reserved, length, protection, MAP_SHARED | MAP_FIXED, myFile, 0);
 
-					if (size > blocks) {
-						auto next = iter + blocks;
+					if (data == MAP_FAILED) {
+						auto const error = errno;
+						unmap_memory(reserved, length, alignment);
 
-						if (next != myInfo.end()) {
-							next->make_head(true, size - blocks);
-							next->prev(*iter);
-						}
+						throw std::system_error{ error, std::generic_category() };
 					}
+				}
 
-					myLoad += static_cast<float>(blocks) / blocks_count;
-					iter->make_head(false, blocks);
-
-					auto const offset  = iter - myInfo.begin();
-					auto const storage = reinterpret_cast<_Ty*>(std::addressof(myData[offset * _Alignment]));
+				myData	 = static_cast<std::byte*>(data);
+				myLength = length;
 
-					return std::assume_aligned<_Alignment>(storage);
-				}
+				return myData;
+#else
+				static_cast<void>(length), static_cast<void>(alignment), static_cast<void>(preferred);
+				throw std::system_error{ std::make_error_code(std::errc::function_not_supported) };
+#endif
+			}
 
-				return nullptr;
+			// Touching the mapping past the end of the file raises SIGBUS, so it is resized before use
+			void resize(size_t bytes)
+			{
+#if defined(__linux__)
+				if (ftruncate(myFile, static_cast<off_t>(bytes)) != 0)
+					throw std::system_error{ errno, std::generic_category() };
+#else
+				static_cast<void>(bytes);
+#endif
 			}
 
-			template <class _Ty>
-			constexpr bool release(_Ty* ptr, size_t count) noexcept {
-				return release(contains(ptr, count));
+			void sync(size_t bytes) noexcept
+			{
+#if defined(__linux__)
+				if (myData != nullptr)
+					msync(myData, std::min(bytes, myLength), MS_SYNC);
+#else
+				static_cast<void>(bytes);
+#endif
 			}
 
-			constexpr bool release(Hint const& hint) noexcept
+			_NODISCARD bool contains(void const* data) const noexcept 
 			{
-				auto iter = from_hint(hint);
+				auto const address = reinterpret_cast<uintptr_t>(data);
+				auto const begin   = reinterpret_cast<uintptr_t>(myData);
 
-				if (iter != myInfo.end())
-				{
-					auto size    = iter->size();
-					auto prev    = iter->prev();
-					auto next    = iter + size;
-					auto farNext = myInfo.end();
+				return myData != nullptr && address >= begin && address - begin < myLength;
+			}
 
-					myLoad -= static_cast<float>(size) / blocks_count;
-					iter->make_head(true, size);
+			_NODISCARD std::byte* data() const noexcept {
+				return myData;
+			}
 
-					if (next != myInfo.end() && next->is_free()) 
-					{
-						auto const nextSize = next->size();
-						farNext = next + nextSize;
+		private:
+			std::byte* myData	= nullptr;
+			size_t	   myLength = 0;
+			int		   myFile	= -1;
+		};
 
-						if (farNext != myInfo.end())
-							farNext->prev(*iter);
+		inline constexpr uint64_t persistent_magic	 = 0x4c4f4f5058575321;
+		inline constexpr uint64_t persistent_version = 1;
 
-						iter->make_head(true, size += nextSize);
-						next->remove_head();
-					}
+		// The first chunk slot of a persistent pool file, everything in it is position independent but the base
+		struct PersistentHeader final
+		{
+			uint64_t  magic			 = 0;
+			uint64_t  version		 = 0;
+			uint64_t  page_size		 = 0;
+			uint64_t  page_alignment = 0;
+			uint64_t  chunk_bytes	 = 0;
+			uint64_t  capacity		 = 0;
+			uint64_t  chunks		 = 0;
+			uint64_t  root			 = 0;
+			uint64_t  clean			 = 0;
+			uintptr_t base			 = 0;
+		};
 
-					if (prev != nullptr && prev->is_free()) 
-					{
-						prev->make_head(true, size + prev->size());
-						iter->remove_head();
+		class NumaPlacement final
+		{
+#if defined(__linux__)
+			static constexpr size_t mask_bits = sizeof(unsigned long) * 8;
 
-						if (farNext != myInfo.end())
-							farNext->prev(prev);
-					}
+		public:
+			NumaPlacement (unsigned node) noexcept :
+				myMask (numa_nodes() / mask_bits + 1)
+			{
+				if (numa_nodes() > 1 && 
+					syscall(SYS_get_mempolicy, &myMode, myMask.data(), myMask.size() * mask_bits, nullptr, 0) == 0
+				) {
+					std::vector<unsigned long> preferred (myMask.size());
+					preferred[node / mask_bits] = 1ul << (node % mask_bits);
 
-					return true;
+					myActive = syscall(SYS_set_mempolicy, MPOL_PREFERRED, preferred.data(), preferred.size() * mask_bits) == 0;
 				}
+			}
 
-				return false;
+			~NumaPlacement() noexcept {
+				if (myActive)
+					syscall(SYS_set_mempolicy, myMode, myMask.data(), myMask.size() * mask_bits);
 			}
 
 		private:
-			alignas(_Alignment) storage_type myData = {};
-							    info_type	 myInfo = {};
-								float		 myLoad = 0;
-		};
+			std::vector<unsigned long> myMask;
 
-		template <
-			size_t _Size,
-			size_t _Alignment,
-			Detail::Allocator _AllocTy = std::allocator <Page<_Size, _Alignment>>
-		>
-		class Pool final
-		{
-			using page_type = Page<_Size, _Alignment>;
+			int  myMode   = MPOL_DEFAULT;
+			bool myActive = false;
+#else
+		public:
+			NumaPlacement (unsigned) noexcept {}
+#endif
 
 		public:
-			using allocator_type = typename std::allocator_traits <_AllocTy>::
-								   template rebind_alloc<std::pair<float const, std::unique_ptr<page_type>>>;
+			NumaPlacement(NumaPlacement&&)      = delete;
+			NumaPlacement(NumaPlacement const&) = delete;
 
-		private:
-			void pages_allocating_proc(std::stop_token stop) 
-			{
-				while (!stop.stop_requested())
-				{
-					constexpr auto maxLoad = page_type::max_load();
+			NumaPlacement& operator=(NumaPlacement&&)      = delete;
+			NumaPlacement& operator=(NumaPlacement const&) = delete;
+		};
 
-					float maxPageLoad;
-					float averageLoad;
+		class NullMutex final
+		{
+		public:
+			constexpr void lock()	noexcept {}
+			constexpr void unlock() noexcept {}
 
-					{
-						decltype(myPages.begin()) first;
+			_NODISCARD constexpr bool try_lock() noexcept {
+				return true;
+			}
 
-						std::shared_lock lock{ myAllocateMutex };
+			constexpr void lock_shared()   noexcept {}
+			constexpr void unlock_shared() noexcept {}
 
-						first = myPages.begin();
-						maxPageLoad = first != myPages.end() ? first->first : maxLoad;
-					}
+			_NODISCARD constexpr bool try_lock_shared() noexcept {
+				return true;
+			}
+		};
 
-					{
-						std::shared_lock lock{ myReserveMutex };
-						averageLoad = myAverageLoadRequest;
-					}
+		class SpinMutex final
+		{
+			static constexpr int exclusive = -1;
 
-					if (maxPageLoad + averageLoad >= maxLoad)
-						make_pages(1);
-					else
-						std::this_thread::yield();
-				}
+			static void pause() noexcept
+			{
+#if defined(__x86_64__) || defined(__i386__)
+				__builtin_ia32_pause();
+#elif defined(__aarch64__)
+				asm volatile ("yield");
+#else
+				std::this_thread::yield();
+#endif
 			}
 
 		public:
-			constexpr Pool (allocator_type const& alloc) noexcept :
-				myPages  (alloc),
-				myThread (pages_allocating_proc, this)
-			{}
+			constexpr SpinMutex() noexcept = default;
+
+			SpinMutex(SpinMutex&&)		= delete;
+			SpinMutex(SpinMutex const&) = delete;
+
+			SpinMutex& operator=(SpinMutex&&)      = delete;
+			SpinMutex& operator=(SpinMutex const&) = delete;
 
-			constexpr ~Pool() noexcept {
-				myThread.request_stop();
-				myThread.join();
+			_NODISCARD bool try_lock() noexcept {
+				int expected = 0;
+				return myState.compare_exchange_strong(expected, exclusive, std::memory_order_acquire, std::memory_order_relaxed);
 			}
 
-			void make_pages(size_t count) 
-			{
-				for (size_t i = 0; i < count; ++i)
-				{
-					auto	   page = std::make_unique<page_type>();
-					auto const load = page->load();
+			void lock() noexcept {
+				while (!try_lock())
+					while (myState.load(std::memory_order_relaxed) != 0)
+						pause();
+			}
 
-					std::unique_lock lock{ myAllocateMutex };
-					
-					myPages.emplace_hint(myPages.begin(), load, std::move(page));
-				}
+			void unlock() noexcept {
+				myState.store(0, std::memory_order_release);
 			}
 
-			template <class _Ty>
-			_NODISCARD _Ty* occupy(size_t count) noexcept 
+			_NODISCARD bool try_lock_shared() noexcept 
 			{
-				auto const load = page_type::load_of<_Ty>(count);
-				_Ty* ptr;
-
-				{
-					std::unique_lock lock{ myAllocateMutex };
+				auto readers = myState.load(std::memory_order_relaxed);
+				return readers != exclusive && 
+					   myState.compare_exchange_strong(readers, readers + 1, std::memory_order_acquire, std::memory_order_relaxed);
+			}
 
-					if (!myPages.empty()) 
-					{
-						auto iter = myPages.upper_bound(page_type::max_load() - load);
+			void lock_shared() noexcept {
+				while (!try_lock_shared())
+					pause();
+			}
 
-						if (iter == myPages.begin())
-							ptr = nullptr;
-						
-						else {
-							auto hint = iter;
-							auto node = myPages.extract(--iter);
+			void unlock_shared() noexcept {
+				myState.fetch_sub(1, std::memory_order_release);
+			}
 
-							auto&	   page = node.mapped();
-							auto const load = page->load();
+		private:
+			std::atomic<int> myState = 0;
+		};
 
-							ptr = page->try_occupy<_Ty>(count);
+		inline constexpr size_t cache_line = 64;
 
-							myPages.emplace_hint(++hint, load, std::move(page));
-						}
-					}
-					else
-						ptr = nullptr;
-				}
+		_NODISCARD inline uint64_t next_generation() noexcept
+		{
+			static std::atomic<uint64_t> generation = 0;
+			return generation.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
 
-				{
-					std::unique_lock lock{ myReserveMutex };
-					myAverageLoadRequest = (myAverageLoadRequest * myRequestsCount + load) / ++myRequestsCount;
-				}
+		inline constexpr size_t copy_stride	   = 32;
+		inline constexpr size_t copy_threshold = 2048;
 
+		// Fixed-size copies of aligned blocks inline to vector moves, beyond the threshold libc's memcpy is faster
+		template <size_t _Alignment>
+		inline void copy_aligned(void* dst, void const* src, size_t bytes) noexcept
+		{
+			if (bytes >= copy_threshold) {
+				std::memcpy(dst, src, bytes);
+				return;
+			}
+
+			auto out = std::assume_aligned<_Alignment>(static_cast<std::byte*>(dst));
+			auto in  = std::assume_aligned<_Alignment>(static_cast<std::byte const*>(src));
+
+			for (; bytes >= copy_stride; bytes -= copy_stride, out += copy_stride, in += copy_stride)
+				std::memcpy(out, in, copy_stride);
+
+			std::memcpy(out, in, bytes);
+		}
+
+		// Read only while the probe is enabled, zero stands for a start that was not timed
+		_NODISCARD inline uint64_t probe_time(bool enabled) noexcept
+		{
+#if SEWEEX_MEMORY_PROBES
+			if (enabled) {
+				auto const now = std::chrono::steady_clock::now().time_since_epoch();
+				return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+			}
+#endif
+			static_cast<void>(enabled);
+			return 0;
+		}
+
+		// A tracer attached while the call ran reports no duration rather than the time since the epoch
+		_NODISCARD inline uint64_t probe_since(uint64_t started) noexcept {
+			return started != 0 ? probe_time(true) - started : 0;
+		}
+
+		// Probe arguments carry loads as 16.16 fixed point, floats are not portable across SDT consumers
+		_NODISCARD constexpr uint32_t probe_load(float load) noexcept {
+			return static_cast<uint32_t>(load * (1 << 16));
+		}
+
+		template <class _ThreadingTy>
+		class EventCounter final
+		{
+#if defined(SEWEEX_MEMORY_POOL_STATISTICS)
+		public:
+			void add(uint64_t count = 1) noexcept {
+				myValue.fetch_add(count, std::memory_order_relaxed);
+			}
+
+			_NODISCARD uint64_t value() const noexcept {
+				return myValue.load(std::memory_order_relaxed);
+			}
+
+		private:
+			typename _ThreadingTy::template atomic_type<uint64_t> myValue = 0;
+#else
+		public:
+			constexpr void add(uint64_t = 1) noexcept {}
+
+			_NODISCARD constexpr uint64_t value() const noexcept {
+				return 0;
+			}
+#endif
+		};
+
+		_NODISCARD inline unsigned thread_shard() noexcept
+		{
+			static std::atomic<unsigned> next = 0;
+			thread_local unsigned const  shard = next.fetch_add(1, std::memory_order_relaxed);
+
+			return shard;
+		}
+
+		template <class _Ty>
+		class Unsynchronized final
+		{
+		public:
+			constexpr Unsynchronized (_Ty value = _Ty()) noexcept :
+				myValue (value)
+			{}
+
+			_NODISCARD constexpr _Ty load(std::memory_order = std::memory_order_seq_cst) const noexcept {
+				return myValue;
+			}
+
+			constexpr void store(_Ty value, std::memory_order = std::memory_order_seq_cst) noexcept {
+				myValue = value;
+			}
+
+			constexpr _Ty fetch_add(_Ty value, std::memory_order = std::memory_order_seq_cst) noexcept {
+				return std::exchange(myValue, myValue + value);
+			}
+
+			constexpr _Ty fetch_sub(_Ty value, std::memory_order = std::memory_order_seq_cst) noexcept {
+				return std::exchange(myValue, myValue - value);
+			}
+
+			constexpr Unsynchronized& operator=(_Ty value) noexcept {
+				myValue = value;
+				return *this;
+			}
+
+			_NODISCARD constexpr operator _Ty() const noexcept {
+				return myValue;
+			}
+
+		private:
+			_Ty myValue;
+		};
+
+		struct OccupyWaiter
+		{
+			OccupyWaiter (
+				size_t								  bytes,
+				size_t								  alignment,
+				std::chrono::steady_clock::time_point deadline
+			) noexcept :
+				bytes	  (bytes),
+				alignment (alignment),
+				deadline  (deadline)
+			{}
+
+			size_t bytes;
+			size_t alignment;
+
+			std::chrono::steady_clock::time_point deadline;
+
+			void*		  result	= nullptr;
+			OccupyWaiter* next		= nullptr;
+			OccupyWaiter* prev		= nullptr;
+			bool		  queued	= false;
+			bool		  cancelled = false;
+
+			virtual void resume() noexcept = 0;
+
+		protected:
+			~OccupyWaiter() = default;
+		};
+
+		inline constexpr size_t heap_sample_rate  = size_t{ 1 } << 19;
+		inline constexpr size_t heap_sample_depth = 32;
+
+#if SEWEEX_MEMORY_PROFILING
+		// Exponentially distributed gaps make the samples a Poisson process over occupied bytes
+		_NODISCARD inline int64_t next_heap_sample(size_t rate) noexcept
+		{
+			thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&state);
+
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+
+			auto const uniform = static_cast<double>((state >> 11) + 1) / static_cast<double>(uint64_t{ 1 } << 53);
+			return static_cast<int64_t>(-std::log(uniform) * static_cast<double>(rate)) + 1;
+		}
+
+		template <class _AllocTy, class _ThreadingTy>
+		class HeapSampler final
+		{
+			struct Sample final
+			{
+				size_t bytes;
+				int	   depth;
+
+				std::array<void*, heap_sample_depth> stack;
+			};
+
+			using samples_type = std::map <uintptr_t, Sample, std::less<uintptr_t>, 
+										   typename std::allocator_traits<_AllocTy>::template rebind_alloc<std::pair<uintptr_t const, Sample>>>;
+
+			static constexpr size_t filter_bits = 10;
+
+			_NODISCARD static size_t filter_of(void const* data) noexcept {
+				return (reinterpret_cast<uintptr_t>(data) >> 4) * 0x9E3779B97F4A7C15ull >> (64 - filter_bits);
+			}
+
+			[[gnu::noinline]] void record(void const* data, size_t bytes) noexcept
+			{
+				Sample sample;
+
+				sample.bytes = bytes;
+				sample.depth = backtrace(sample.stack.data(), static_cast<int>(sample.stack.size()));
+
+				std::unique_lock lock{ myMutex };
+
+				try {
+					auto const [iter, inserted] = mySamples.insert_or_assign(reinterpret_cast<uintptr_t>(data), sample);
+
+					if (inserted)
+						myFilter[filter_of(data)].fetch_add(1, std::memory_order_relaxed);
+				}
+				catch (...) {}
+			}
+
+			void forget(void const* data) noexcept
+			{
+				std::unique_lock lock{ myMutex };
+
+				if (mySamples.erase(reinterpret_cast<uintptr_t>(data)) != 0)
+					myFilter[filter_of(data)].fetch_sub(1, std::memory_order_relaxed);
+			}
+
+		public:
+			HeapSampler (_AllocTy const& alloc) :
+				mySamples (alloc)
+			{}
+
+			void rate(size_t bytes) noexcept {
+				myRate.store(bytes, std::memory_order_relaxed);
+			}
+
+			_NODISCARD size_t rate() const noexcept {
+				return myRate.load(std::memory_order_relaxed);
+			}
+
+			void occupied(void const* data, size_t bytes) noexcept
+			{
+				thread_local int64_t countdown = 0;
+
+				auto const rate = myRate.load(std::memory_order_relaxed);
+
+				if (rate == 0 || (countdown -= static_cast<int64_t>(bytes)) > 0)
+					return;
+
+				countdown = next_heap_sample(rate);
+				record(data, bytes);
+			}
+
+			void released(void const* data) noexcept {
+				if (myFilter[filter_of(data)].load(std::memory_order_relaxed) != 0)
+					forget(data);
+			}
+
+			void dump(std::ostream& stream) const
+			{
+				std::vector<Sample> samples;
+
+				{
+					std::unique_lock lock{ myMutex };
+					samples.reserve(mySamples.size());
+
+					for (auto const& [data, sample] : mySamples)
+						samples.push_back(sample);
+				}
+
+				auto const frames = [] (Sample const& sample) noexcept {
+					return std::span{ sample.stack.data() + 1, static_cast<size_t>(std::max(sample.depth - 1, 0)) };
+				};
+
+				auto const before = [&frames] (Sample const& lhs, Sample const& rhs) noexcept {
+					return std::ranges::lexicographical_compare(frames(lhs), frames(rhs));
+				};
+
+				std::sort(samples.begin(), samples.end(), before);
+
+				size_t totalBytes = 0;
+
+				for (auto const& sample : samples)
+					totalBytes += sample.bytes;
+
+				stream << "heap profile: " << samples.size() << ": " << totalBytes
+					   << " [" << samples.size() << ": " << totalBytes << "] @ heap_v2/" << rate() << '\n';
+
+				for (auto first = samples.begin(); first != samples.end(); )
+				{
+					auto   last  = first;
+					size_t count = 0;
+					size_t bytes = 0;
+
+					for (; last != samples.end() && !before(*first, *last); ++last) {
+						++count;
+						bytes += last->bytes;
+					}
+
+					stream << count << ": " << bytes << " [" << count << ": " << bytes << "] @" << std::hex;
+
+					for (auto const frame : frames(*first))
+						stream << " 0x" << reinterpret_cast<uintptr_t>(frame);
+
+					stream << std::dec << '\n';
+					first = last;
+				}
+
+				stream << "\nMAPPED_LIBRARIES:\n" << std::ifstream{ "/proc/self/maps" }.rdbuf();
+			}
+
+		private:
+			mutable typename _ThreadingTy::mutex_type myMutex;
+			samples_type							  mySamples;
+
+			typename _ThreadingTy::template atomic_type<size_t> myRate = heap_sample_rate;
+
+			std::array<typename _ThreadingTy::template atomic_type<uint32_t>, size_t{ 1 } << filter_bits> myFilter = {};
+		};
+#else
+		template <class _AllocTy, class _ThreadingTy>
+		class HeapSampler final
+		{
+		public:
+			constexpr HeapSampler (_AllocTy const&) noexcept {}
+
+			constexpr void rate(size_t) noexcept {}
+
+			_NODISCARD constexpr size_t rate() const noexcept {
+				return 0;
+			}
+
+			constexpr void occupied(void const*, size_t) noexcept {}
+			constexpr void released(void const*) noexcept {}
+
+			void dump(std::ostream& stream) const {
+				stream << "heap profile: 0: 0 [0: 0] @ heap_v2/0\n";
+			}
+		};
+#endif
+	}
+
+	namespace Memory
+	{
+		struct PoolStatistics final
+		{
+			size_t pages			 = 0;
+			size_t chunks			 = 0;
+			size_t committed_bytes	 = 0;
+			size_t occupied_bytes	 = 0;
+			size_t metadata_bytes	 = 0;
+			size_t largest_free_run	 = 0;
+			size_t large_allocations = 0;
+			size_t large_bytes		 = 0;
+
+			std::array<size_t, 10> load_histogram = {};
+
+			uint64_t occupy_succeeded = 0;
+			uint64_t occupy_failed	  = 0;
+			uint64_t growth_events	  = 0;
+			uint64_t trim_events	  = 0;
+		};
+
+		namespace Threading
+		{
+			struct Single final
+			{
+				using mutex_type = Detail::NullMutex;
+
+				template <class _Ty>
+				using atomic_type = Detail::Unsynchronized<_Ty>;
+
+				static constexpr bool replenishing = false;
+			};
+
+			struct Blocking final
+			{
+				using mutex_type = std::shared_mutex;
+
+				template <class _Ty>
+				using atomic_type = std::atomic<_Ty>;
+
+				static constexpr bool replenishing = true;
+			};
+
+			struct Spinning final
+			{
+				using mutex_type = Detail::SpinMutex;
+
+				template <class _Ty>
+				using atomic_type = std::atomic<_Ty>;
+
+				static constexpr bool replenishing = true;
+			};
+
+			// Blocking without the replenisher thread, every growth happens on the occupying thread
+			struct Inline final
+			{
+				using mutex_type = std::shared_mutex;
+
+				template <class _Ty>
+				using atomic_type = std::atomic<_Ty>;
+
+				static constexpr bool replenishing = false;
+			};
+		}
+
+		namespace Occupy
+		{
+			// The best fitting page and the emptiest one, growth is left to the replenisher
+			struct Fast final
+			{
+				static constexpr size_t candidates = 1;
+				static constexpr size_t growths	   = 0;
+			};
+
+			// A few more fitting pages than bounded, then inline growth until the page allocator gives up.
+			// The walk runs under the pool lock, so it stays capped and fragmented pools grow instead
+			struct Guaranteed final
+			{
+				static constexpr size_t candidates = 32;
+				static constexpr size_t growths	   = std::numeric_limits<size_t>::max();
+			};
+
+			// At most _Candidates pages are searched and the pool grows at most once
+			template <size_t _Candidates = 8>
+			requires (_Candidates > 0)
+			struct Bounded final
+			{
+				static constexpr size_t candidates = _Candidates;
+				static constexpr size_t growths	   = 1;
+			};
+		}
+
+		// What a persistent pool does with a file that was not closed cleanly, its pages may be torn
+		enum class Recovery
+		{
+			reject,
+			discard
+		};
+
+		template <size_t _Size, size_t _Alignment>
+		requires (
+			std::has_single_bit(_Alignment) &&
+			_Size % _Alignment == 0 &&
+			_Size > 0
+		)
+		class alignas(_Alignment) Page final
+		{
+			static constexpr size_t blocks_count = _Size / _Alignment;
+
+			using storage_type = std::array<unsigned char, _Size>;
+			using info_type    = std::array<Detail::PageBlockInfo, blocks_count>;
+
+		public:
+			class Hint final
+			{
+			private:
+				friend class Page;
+
+				using iterator = typename info_type::const_iterator;
+
+				constexpr Hint (
+					iterator iter,
+					iterator end
+				) noexcept :
+					myIter (iter),
+					myEnd  (end)
+				{}
+
+				constexpr Hint (iterator end) noexcept :
+					myIter (end),
+					myEnd  (end)
+				{}
+
+			public:
+				constexpr Hint() noexcept = default;
+
+				constexpr Hint(Hint&&)      noexcept = default;
+				constexpr Hint(Hint const&) noexcept = default;
+
+				constexpr Hint& operator=(Hint&&)      noexcept = default;
+				constexpr Hint& operator=(Hint const&) noexcept = default;
+
+				_NODISCARD constexpr bool is_valid() const noexcept {
+					return std::holds_alternative<iterator>(myEnd) 
+						&& myIter != std::get<iterator>(myEnd);
+				}
+
+				_NODISCARD constexpr bool is_valid(iterator const& trueEnd) const noexcept {
+					if (std::holds_alternative<iterator>(myEnd)) {
+						auto const& end = std::get<iterator>(myEnd);
+						return end == trueEnd && myIter != end;
+					}
+					else 
+						return false;
+				}
+
+				_NODISCARD constexpr operator bool() const noexcept {
+					return is_valid();
+				}
+
+			private:
+				iterator myIter;
+				std::variant<std::monostate, iterator> myEnd;
+			};
+
+		private:
+			template <class _Ty>
+			_NODISCARD static constexpr size_t size_in_blocks(size_t count) noexcept {
+				return std::max<size_t>((sizeof(_Ty) * count + _Alignment - 1) / _Alignment, 1);
+			}
+
+			_NODISCARD constexpr size_t lead_of(typename info_type::const_iterator iter, size_t alignment) const noexcept 
+			{
+				auto const address = reinterpret_cast<uintptr_t>(std::addressof(myData[(iter - myInfo.cbegin()) * _Alignment]));
+				return (alignment - address % alignment) % alignment / _Alignment;
+			}
+
+			_NODISCARD constexpr typename info_type::iterator from_hint(Hint const& hint) noexcept 
+			{
+				return hint.is_valid(myInfo.cend()) ?
+					   myInfo.begin() + (hint.myIter - myInfo.cbegin()) :
+					   myInfo.end();
+			}
+
+		public:
+			constexpr Page() noexcept {
+				myInfo.front().make_head(true, blocks_count);
+			}
+
+			Page(Page&&)	  = delete;
+			Page(Page const&) = delete;
+
+			Page& operator=(Page&&)      = delete;
+			Page& operator=(Page const&) = delete;
+
+			template <class _Ty>
+			_NODISCARD static constexpr float load_of(size_t count) noexcept {
+				constexpr float step = sizeof(_Ty) / static_cast<float>(_Size);
+				return step * count;
+			}
+
+			_NODISCARD static constexpr float max_load() noexcept {
+				return 1;
+			}
+
+			_NODISCARD float load() const noexcept {
+				return myLoad;
+			}
+
+			_NODISCARD constexpr bool empty() const noexcept {
+				return myInfo.front().is_free() && myInfo.front().size() == blocks_count;
+			}
+
+			_NODISCARD constexpr size_t occupied() const noexcept 
+			{
+				size_t blocks = 0;
+
+				for (auto iter = myInfo.begin(); iter != myInfo.end(); iter += iter->size())
+					if (!iter->is_free())
+						blocks += iter->size();
+
+				return blocks * _Alignment;
+			}
+
+			_NODISCARD constexpr size_t largest_free() const noexcept 
+			{
+				size_t blocks = 0;
+
+				for (auto iter = myInfo.begin(); iter != myInfo.end(); iter += iter->size())
+					if (iter->is_free())
+						blocks = std::max(blocks, iter->size());
+
+				return blocks * _Alignment;
+			}
+
+			template <class _Ty>
+			_NODISCARD constexpr Hint fit(size_t count) const noexcept 
+			{
+				if constexpr (alignof(_Ty) <= _Alignment)
+				{
+					auto const blocks = size_in_blocks<_Ty>(count);
+					auto	   iter   = myInfo.begin();
+
+					while (iter != myInfo.end()) {
+						auto const size = iter->size();
+
+						if (iter->is_free() && size >= blocks)
+							return { iter, myInfo.end() };
+
+						iter += size;
+					}
+				}
+				
+				return { myInfo.end() };
+			}
+
+			template <class _Ty>
+			_NODISCARD constexpr Hint contains(_Ty* data, size_t count) const noexcept 
+			{
+				if constexpr (alignof(_Ty) <= _Alignment)
+				{
+					auto const storageBegin = reinterpret_cast<uintptr_t>(myData.data());
+					auto const storageEnd   = storageBegin + _Size;
+
+					auto const dataBegin = reinterpret_cast<uintptr_t>(data);
+					auto const dataEnd   = reinterpret_cast<uintptr_t>(data + count);
+
+					if (dataBegin >= storageBegin && 
+						dataEnd <= storageEnd &&
+						dataBegin % _Alignment == 0
+					) {
+						auto const offset = (dataBegin - storageBegin) / _Alignment;
+						auto const blocks = size_in_blocks<_Ty>(count);
+						auto	   iter	  = myInfo.begin() + offset;
+
+						if (!iter->is_free() && iter->size() == blocks)
+							return { iter, myInfo.end() };
+					}
+				}
+
+				return { myInfo.end() };
+			}
+
+			_NODISCARD constexpr Hint fit(size_t bytes, size_t alignment) const noexcept 
+			{
+				auto const blocks = size_in_blocks<std::byte>(bytes);
+				auto	   iter   = myInfo.begin();
+
+				while (iter != myInfo.end()) {
+					auto const size = iter->size();
+
+					if (iter->is_free() && size >= lead_of(iter, alignment) + blocks)
+						return { iter, myInfo.end() };
+
+					iter += size;
+				}
+				
+				return { myInfo.end() };
+			}
+
+			template <class _Ty>
+			_NODISCARD constexpr _Ty* try_occupy(size_t count) noexcept {
+				return try_occupy<_Ty>(count, fit<_Ty>(count));
+			}
+
+			// Checks the hint before trusting it and moves it past the occupied blocks, so a held hint never goes stale
+			template <class _Ty>
+			_NODISCARD constexpr _Ty* try_occupy_next(size_t count, Hint& hint) noexcept
+			{
+				auto const blocks = size_in_blocks<_Ty>(count);
+				auto const iter	  = from_hint(hint);
+
+				if (iter == myInfo.end() || !iter->is_free() || iter->size() < blocks)
+					return nullptr;
+
+				auto const ptr  = try_occupy<_Ty>(count, hint);
+				auto const next = iter + blocks;
+
+				hint = next != myInfo.end() ? 
+					   Hint{ typename info_type::const_iterator(next), myInfo.cend() } : 
+					   Hint{ myInfo.cend() };
+
+				return ptr;
+			}
+
+			// Leaves the blocks in front of the aligned position as a free run of their own
+			_NODISCARD constexpr void* try_occupy(size_t bytes, size_t alignment, Hint const& hint) noexcept
+			{
+				auto iter = from_hint(hint);
+
+				if (iter == myInfo.end())
+					return nullptr;
+
+				auto const size = iter->size();
+				auto const lead = lead_of(iter, alignment);
+
+				if (size < lead + size_in_blocks<std::byte>(bytes))
+					return nullptr;
+
+				if (lead != 0) {
+					auto next  = iter + lead;
+					auto after = iter + size;
+
+					iter->make_head(true, lead);
+					next->make_head(true, size - lead);
+					next->prev(*iter);
+
+					if (after != myInfo.end())
+						after->prev(*next);
+
+					iter = next;
+				}
+
+				return try_occupy<std::byte>(bytes, Hint{ iter, myInfo.cend() });
+			}
+
+			template <class _Ty>
+			_NODISCARD constexpr _Ty* try_occupy(size_t count, Hint const& hint) noexcept
+			{
+				auto const blocks = size_in_blocks<_Ty>(count);
+				auto	   iter   = from_hint(hint);
+
+				if (iter != myInfo.end())
+				{
+					auto const size = iter->size();
+
+					if (size > blocks) {
+						auto next  = iter + blocks;
+						auto after = iter + size;
+
+						next->make_head(true, size - blocks);
+						next->prev(*iter);
+
+						if (after != myInfo.end())
+							after->prev(*next);
+					}
+
+					myLoad += static_cast<float>(blocks) / blocks_count;
+					iter->make_head(false, blocks);
+
+					auto const offset  = iter - myInfo.begin();
+					auto const storage = reinterpret_cast<_Ty*>(std::addressof(myData[offset * _Alignment]));
+
+					SEWEEX_MEMORY_PROBE(page_occupy, this, storage, blocks * _Alignment, Detail::probe_load(myLoad));
+					return std::assume_aligned<_Alignment>(storage);
+				}
+
+				return nullptr;
+			}
+
+			// Grows into the free run behind the block or gives its tail back, the block never moves
+			template <class _Ty>
+			constexpr bool try_resize(_Ty* ptr, size_t count, size_t newCount) noexcept
+			{
+				auto const iter = from_hint(contains(ptr, count));
+
+				if (iter == myInfo.end())
+					return false;
+
+				auto const size   = iter->size();
+				auto const blocks = size_in_blocks<_Ty>(newCount);
+				auto const next   = iter + size;
+
+				if (blocks > size)
+				{
+					if (next == myInfo.end() || !next->is_free() || size + next->size() < blocks)
+						return false;
+
+					auto const total = size + next->size();
+					auto const after = iter + total;
+
+					next->remove_head();
+
+					if (total > blocks) {
+						auto rest = iter + blocks;
+
+						rest->make_head(true, total - blocks);
+						rest->prev(*iter);
+
+						if (after != myInfo.end())
+							after->prev(*rest);
+					}
+					else if (after != myInfo.end())
+						after->prev(*iter);
+				}
+				else if (blocks < size)
+				{
+					auto rest	  = iter + blocks;
+					auto restSize = size - blocks;
+
+					if (next != myInfo.end() && next->is_free()) {
+						restSize += next->size();
+						next->remove_head();
+					}
+
+					rest->make_head(true, restSize);
+					rest->prev(*iter);
+
+					if (auto const after = rest + restSize; after != myInfo.end())
+						after->prev(*rest);
+				}
+
+				myLoad += (static_cast<float>(blocks) - static_cast<float>(size)) / blocks_count;
+				iter->make_head(false, blocks);
+
+				return true;
+			}
+
+			template <class _Ty>
+			constexpr bool release(_Ty* ptr, size_t count) noexcept {
+				return release(contains(ptr, count));
+			}
+
+			constexpr bool release(Hint const& hint) noexcept
+			{
+				auto iter = from_hint(hint);
+
+				if (iter != myInfo.end())
+				{
+					auto size = iter->size();
+					auto prev = iter->prev();
+					auto next = iter + size;
+					auto head = std::addressof(*iter);
+
+					myLoad -= static_cast<float>(size) / blocks_count;
+					iter->make_head(true, size);
+
+					SEWEEX_MEMORY_PROBE(page_release, this, std::addressof(myData[(iter - myInfo.begin()) * _Alignment]), 
+										size * _Alignment, Detail::probe_load(myLoad));
+
+					if (next != myInfo.end() && next->is_free()) 
+					{
+						iter->make_head(true, size += next->size());
+						next->remove_head();
+						next = iter + size;
+					}
+
+					if (prev != nullptr && prev->is_free()) 
+					{
+						prev->make_head(true, size + prev->size());
+						iter->remove_head();
+						head = prev;
+					}
+
+					if (next != myInfo.end())
+						next->prev(head);
+
+					return true;
+				}
+
+				return false;
+			}
+
+		private:
+			// The storage is left uninitialised, so the pages of a chunk are committed only once they are used
+			alignas(_Alignment) storage_type myData;
+							    info_type	 myInfo = {};
+								float		 myLoad = 0;
+		};
+
+		template <
+			size_t _Size,
+			size_t _Alignment,
+			Detail::Allocator _AllocTy = std::allocator <Page<_Size, _Alignment>>,
+			class _ThreadingTy = Threading::Blocking
+		>
+		class Pool final
+		{
+			using page_type = Page<_Size, _Alignment>;
+
+		public:
+			static constexpr size_t page_size	   = _Size;
+			static constexpr size_t page_alignment = _Alignment;
+
+			using allocator_type = typename std::allocator_traits <_AllocTy>::
+								   template rebind_alloc<std::pair<float const, page_type*>>;
+
+		private:
+			using index_type = std::multimap <float, page_type*, std::less<float>, allocator_type>;
+
+			struct Slot final
+			{
+				typename index_type::iterator where;
+				unsigned					  node = 0;
+			};
+
+			static constexpr size_t chunk_bytes = size_t{ 1 } << 21;
+			static constexpr size_t chunk_entry = sizeof(page_type) + sizeof(Slot);
+			static constexpr size_t chunk_slack = std::max(alignof(page_type), alignof(Slot)) + sizeof(void*);
+
+		public:
+			static constexpr size_t chunk_pages = chunk_entry + chunk_slack < chunk_bytes ? 
+												  (chunk_bytes - chunk_slack) / chunk_entry : 1;
+
+			static constexpr size_t chunk_alignment = std::bit_ceil(chunk_pages * chunk_entry + chunk_slack);
+
+		private:
+			struct alignas(chunk_alignment) Chunk final
+			{
+				static constexpr size_t page_count = chunk_pages;
+
+				// User provided, so that value initialisation does not zero the page storage first
+				Chunk() noexcept {}
+
+				std::array<page_type, chunk_pages> pages;
+				std::array<Slot, chunk_pages>	   slots;
+				Pool*							   owner = nullptr;
+			};
+
+			static_assert(sizeof(Chunk) == chunk_alignment);
+
+			static_assert(Detail::huge_page_size_of<_AllocTy> <= chunk_bytes, 
+						  "pool chunks are 2 MiB, a larger huge page would back no more than one of them");
+
+		public:
+			using chunk_type = Chunk;
+
+			// Remembers a page and a position in it, every trim invalidates all hints of the pool
+			class Hint final
+			{
+			private:
+				friend class Pool;
+
+			public:
+				constexpr Hint() noexcept = default;
+
+				constexpr Hint(Hint&&)      noexcept = default;
+				constexpr Hint(Hint const&) noexcept = default;
+
+				constexpr Hint& operator=(Hint&&)      noexcept = default;
+				constexpr Hint& operator=(Hint const&) noexcept = default;
+
+			private:
+				page_type*				 myPage		  = nullptr;
+				typename page_type::Hint myPageHint;
+				uint64_t				 myGeneration = 0;
+			};
+
+			using page_allocator_type = typename std::allocator_traits <_AllocTy>::
+										template rebind_alloc<chunk_type>;
+
+		private:
+			template <class _OtherTy>
+			using rebind_type = typename std::allocator_traits <_AllocTy>::template rebind_alloc<_OtherTy>;
+
+			using chunk_traits = std::allocator_traits <page_allocator_type>;
+			using chunks_type  = std::vector <chunk_type*, rebind_type<chunk_type*>>;
+
+			struct Large final
+			{
+				size_t length;
+				size_t alignment;
+			};
+
+			using large_type = std::map <uintptr_t, Large, std::less<uintptr_t>, rebind_type<std::pair<uintptr_t const, Large>>>;
+
+			static constexpr size_t request_shards = 64;
+			static constexpr float  request_scale  = 1 << 16;
+
+			struct alignas(Detail::cache_line) RequestShard final
+			{
+				typename _ThreadingTy::template atomic_type<uint64_t> load  = 0;
+				typename _ThreadingTy::template atomic_type<uint64_t> count = 0;
+
+				[[no_unique_address]] Detail::EventCounter<_ThreadingTy> succeeded;
+				[[no_unique_address]] Detail::EventCounter<_ThreadingTy> failed;
+			};
+
+			struct Node final
+			{
+				Node (allocator_type const& alloc) :
+					pages (alloc)
+				{}
+
+				index_type		  pages;
+				typename _ThreadingTy::template atomic_type<bool> demanded = false;
+			};
+
+			template <class _Ty>
+			static constexpr size_t alignment_of = std::max(alignof(_Ty), _Alignment);
+
+			// Pages know over-aligned blocks only as the bytes they were carved from
+			template <class _Ty>
+			static bool release_in(page_type& page, _Ty* ptr, size_t count) noexcept
+			{
+				if constexpr (alignof(_Ty) > _Alignment)
+					return page.release(reinterpret_cast<std::byte*>(ptr), sizeof(_Ty) * count);
+				else
+					return page.release(ptr, count);
+			}
+
+			template <class _Ty>
+			static bool resize_in(page_type& page, _Ty* ptr, size_t count, size_t newCount) noexcept
+			{
+				if constexpr (alignof(_Ty) > _Alignment)
+					return page.try_resize(reinterpret_cast<std::byte*>(ptr), sizeof(_Ty) * count, sizeof(_Ty) * newCount);
+				else
+					return page.try_resize(ptr, count, newCount);
+			}
+
+			_NODISCARD unsigned local_node() const noexcept {
+				return myNodes.size() > 1 ? Detail::numa_node() : 0;
+			}
+
+			_NODISCARD static Chunk& chunk_of(void const* data) noexcept {
+				return *reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(data) & ~(chunk_alignment - 1));
+			}
+
+			_NODISCARD static page_type* page_of(void const* data) noexcept 
+			{
+				auto& chunk = chunk_of(data);
+				auto  index = (reinterpret_cast<uintptr_t>(data) - reinterpret_cast<uintptr_t>(chunk.pages.data())) / sizeof(page_type);
+
+				return index < chunk_pages ? std::addressof(chunk.pages[index]) : nullptr;
+			}
+
+			_NODISCARD static Slot& slot_of(page_type const& page) noexcept 
+			{
+				auto& chunk = chunk_of(std::addressof(page));
+				return chunk.slots[std::addressof(page) - chunk.pages.data()];
+			}
+
+			template <class _Ty>
+			_NODISCARD static bool is_large(size_t count, size_t alignment = alignof(_Ty)) noexcept 
+			{
+				auto const lead = std::max(alignment, _Alignment) - _Alignment;
+				return lead >= _Size || count > (_Size - lead) / sizeof(_Ty);
+			}
+
+			void rekey(page_type& page) noexcept
+			{
+				auto& slot  = slot_of(page);
+				auto& pages = myNodes[slot.node].pages;
+				auto  node  = pages.extract(slot.where);
+
+				node.key()  = page.load();
+				slot.where  = pages.insert(std::move(node));
+			}
+
+			template <class _Ty>
+			_NODISCARD _Ty* try_occupy(page_type& page, size_t count, size_t alignment) noexcept
+			{
+				_Ty* ptr;
+
+				if (alignment <= _Alignment) 
+				{
+					auto const hint = page.template fit<_Ty>(count);
+
+					if (!hint)
+						return nullptr;
+
+					ptr = page.template try_occupy<_Ty>(count, hint);
+				}
+				else
+				{
+					auto const hint = page.fit(sizeof(_Ty) * count, alignment);
+
+					if (!hint)
+						return nullptr;
+
+					ptr = static_cast<_Ty*>(page.try_occupy(sizeof(_Ty) * count, alignment, hint));
+				}
+
+				rekey(page);
+				return ptr;
+			}
+
+			// Walks from the fullest page that may fit towards emptier ones, the emptiest page is always the last resort
+			template <class _Ty, size_t _Candidates>
+			_NODISCARD _Ty* try_occupy(index_type& pages, size_t count, size_t alignment, float load) noexcept
+			{
+				auto iter = pages.upper_bound(page_type::max_load() - load);
+
+				for (size_t tried = 0; iter != pages.begin() && tried < _Candidates; ++tried)
+					if (auto const ptr = try_occupy<_Ty>(*(--iter)->second, count, alignment))
+						return ptr;
+
+				if (iter != pages.begin())
+					return try_occupy<_Ty>(*pages.begin()->second, count, alignment);
+
+				return nullptr;
+			}
+
+			_NODISCARD static bool is_empty(chunk_type const& chunk) noexcept
+			{
+				return std::all_of(chunk.pages.begin(), chunk.pages.end(), [] (page_type const& page) noexcept {
+					return page.empty();
+				});
+			}
+
+			// The header takes the first chunk slot of the file, the chunk at `index` lives in the slot after it
+			_NODISCARD chunk_type* persistent_chunk(size_t index) const noexcept {
+				return reinterpret_cast<chunk_type*>(myFile.data() + (index + 1) * sizeof(chunk_type));
+			}
+
+			_NODISCARD bool is_persistent(chunk_type const* chunk) const noexcept {
+				return myFile.contains(chunk);
+			}
+
+			// Persistent chunks are given back only by shrinking the file
+			void drop(chunk_type* chunk) noexcept
+			{
+				if (!is_persistent(chunk)) {
+					chunk_traits::destroy(myPageAllocator, chunk);
+					chunk_traits::deallocate(myPageAllocator, chunk, 1);
+				}
+			}
+
+			// Claimed chunks are contiguous at the end of the file, the file is resized before any of them is touched
+			void claim(chunks_type& chunks, size_t count)
+			{
+				std::unique_lock lock{ myFileMutex };
+				auto const first = myHeader->chunks;
+
+				if (count > myHeader->capacity - first)
+					throw std::bad_alloc{};
+
+				myFile.resize((first + count + 1) * sizeof(chunk_type));
+				myHeader->chunks = first + count;
+
+				for (size_t i = 0; i < count; ++i)
+					chunks.push_back(std::construct_at(persistent_chunk(first + i)));
+			}
+
+			void unclaim(chunks_type const& chunks) noexcept
+			{
+				std::unique_lock lock{ myFileMutex };
+
+				if (!chunks.empty() && persistent_chunk(myHeader->chunks - 1) == chunks.back())
+					myHeader->chunks -= chunks.size();
+			}
+
+			// An empty file starts over and a cleanly closed one of the same layout is adopted, any other file is left untouched
+			void open(std::filesystem::path const& path, size_t pages, Recovery recovery)
+			{
+				Detail::PersistentHeader header{};
+
+				auto const fresh = myFile.size() == 0;
+
+				if (!fresh)
+				{
+					auto const matching = myFile.read(std::addressof(header), sizeof(header)) &&
+										  header.magic			== Detail::persistent_magic	  &&
+										  header.version		== Detail::persistent_version &&
+										  header.page_size		== _Size					  &&
+										  header.page_alignment == _Alignment				  &&
+										  header.chunk_bytes	== sizeof(chunk_type)		  &&
+										  header.chunks			<= header.capacity;
+
+					if (!matching)
+						throw std::system_error{ std::make_error_code(std::errc::invalid_argument), path.string() };
+
+					if (header.clean == 0 && recovery != Recovery::discard)
+						throw std::system_error{ std::make_error_code(std::errc::state_not_recoverable), path.string() };
+				}
+
+				auto const valid = !fresh && header.clean != 0;
+
+				auto const capacity = std::max<size_t>((pages + chunk_pages - 1) / chunk_pages, valid ? header.capacity : 0);
+
+				if (capacity >= std::numeric_limits<size_t>::max() / sizeof(chunk_type))
+					throw std::bad_alloc{};
+
+				auto const data = myFile.map((capacity + 1) * sizeof(chunk_type), chunk_alignment, valid ? header.base : 0);
+
+				if (!valid) {
+					myFile.resize(0);
+					myFile.resize(sizeof(chunk_type));
+
+					header = { Detail::persistent_magic, Detail::persistent_version, _Size, _Alignment, sizeof(chunk_type) };
+				}
+
+				myHeader	 = ::new (data) Detail::PersistentHeader{ header };
+				myRelocation = valid ? reinterpret_cast<intptr_t>(data) - static_cast<intptr_t>(header.base) : 0;
+
+				myHeader->capacity = capacity;
+				myHeader->base	   = reinterpret_cast<uintptr_t>(data);
+				myHeader->clean	   = 0;
+
+				auto const node = local_node();
+				auto&	   index = myNodes[node].pages;
+
+				myChunks.reserve(myHeader->chunks);
+
+				for (size_t i = 0; i < myHeader->chunks; ++i)
+				{
+					auto const chunk = persistent_chunk(i);
+					chunk->owner = this;
+
+					for (size_t slot = 0; slot < chunk_pages; ++slot) {
+						auto& page = chunk->pages[slot];
+
+						chunk->slots[slot].node	 = node;
+						chunk->slots[slot].where = index.emplace(page.load(), std::addressof(page));
+					}
+
+					myChunks.push_back(chunk);
+				}
+			}
+
+			void grow(size_t count, unsigned node) 
+			{
+				[[maybe_unused]] auto const started = Detail::probe_time(SEWEEX_MEMORY_PROBE_ENABLED(grow));
+
+				auto const chunksCount = (count + chunk_pages - 1) / chunk_pages;
+
+				// Growths of a file are serialised until their pages are indexed, one that finds the capacity taken then finds those pages
+				std::unique_lock growthLock{ myGrowthMutex, std::defer_lock };
+
+				if (myHeader != nullptr)
+					growthLock.lock();
+
+				chunks_type chunks (myChunks.get_allocator());
+				index_type	pages  (myNodes[node].pages.get_allocator());
+
+				chunks.reserve(chunksCount);
+
+				auto const abandon = [this, &chunks] () noexcept 
+				{
+					if (myHeader != nullptr)
+						unclaim(chunks);
+					else
+						for (auto const chunk : chunks)
+							drop(chunk);
+				};
+
+				try {
+					Detail::NumaPlacement placement{ node };
+
+					if (myHeader != nullptr)
+						claim(chunks, chunksCount);
+					else
+						for (size_t i = 0; i < chunksCount; ++i)
+						{
+							auto const chunk = chunk_traits::allocate(myPageAllocator, 1);
+
+							try {
+								chunk_traits::construct(myPageAllocator, chunk);
+							}
+							catch (...) {
+								chunk_traits::deallocate(myPageAllocator, chunk, 1);
+								throw;
+							}
+
+							chunks.push_back(chunk);
+						}
+
+					for (auto const chunk : chunks)
+					{
+						chunk->owner = this;
+
+						for (size_t i = 0; i < chunk_pages; ++i) {
+							auto& page = chunk->pages[i];
+
+							chunk->slots[i].node  = node;
+							chunk->slots[i].where = pages.emplace_hint(pages.end(), page.load(), std::addressof(page));
+						}
+					}
+				}
+				catch (...) {
+					abandon();
+					throw;
+				}
+
+				// Nothing may allocate under the lock, a larger chunk list is reserved outside of it and swapped in
+				chunks_type spare (myChunks.get_allocator());
+
+				for (;;)
+				{
+					size_t needed;
+
+					{
+						std::unique_lock lock{ myAllocateMutex };
+						needed = myChunks.size() + chunks.size();
+
+						if (myChunks.capacity() < needed && spare.capacity() >= needed) {
+							spare.assign(myChunks.begin(), myChunks.end());
+							myChunks.swap(spare);
+						}
+
+						if (myChunks.capacity() >= needed)
+						{
+							for (auto const chunk : chunks)
+								myChunks.insert(std::lower_bound(myChunks.begin(), myChunks.end(), chunk, std::less<>{}), chunk);
+
+							myNodes[node].pages.merge(pages);
+							myGrowths.add();
+
+							break;
+						}
+					}
+
+					try {
+						spare.clear();
+						spare.reserve(needed * 2);
+					}
+					catch (...) {
+						abandon();
+						throw;
+					}
+				}
+
+				SEWEEX_MEMORY_PROBE(grow, count, node, chunksCount * chunk_pages, Detail::probe_since(started));
+			}
+
+			void link(Detail::OccupyWaiter& waiter) noexcept
+			{
+				waiter.prev	  = myWaitTail;
+				waiter.next	  = nullptr;
+				waiter.queued = true;
+
+				(myWaitTail != nullptr ? myWaitTail->next : myWaitHead) = std::addressof(waiter);
+				myWaitTail = std::addressof(waiter);
+			}
+
+			void unlink(Detail::OccupyWaiter& waiter) noexcept
+			{
+				(waiter.prev != nullptr ? waiter.prev->next : myWaitHead) = waiter.next;
+				(waiter.next != nullptr ? waiter.next->prev : myWaitTail) = waiter.prev;
+
+				waiter.queued = false;
+				myWaiting.fetch_sub(1, std::memory_order_relaxed);
+			}
+
+			// Expired waiters are always completed, the others only when occupying and their memory is available
+			void notify_waiters(bool occupying = true) noexcept
+			{
+				if (myWaiting.load(std::memory_order_relaxed) == 0)
+					return;
+
+				Detail::OccupyWaiter* first = nullptr;
+				Detail::OccupyWaiter* last	= nullptr;
+
+				{
+					std::unique_lock lock{ myWaitMutex };
+					auto const now = std::chrono::steady_clock::now();
+
+					for (auto waiter = myWaitHead; waiter != nullptr; )
+					{
+						auto const next = waiter->next;
+
+						if (now >= waiter->deadline || 
+							(occupying && (waiter->result = occupy_bytes(waiter->bytes, waiter->alignment)) != nullptr)
+						) {
+							unlink(*waiter);
+
+							waiter->next = nullptr;
+							(last != nullptr ? last->next : first) = waiter;
+							last = waiter;
+						}
+
+						waiter = next;
+					}
+				}
+
+				while (first != nullptr)
+					std::exchange(first, first->next)->resume();
+			}
+
+			_NODISCARD static Hint& thread_hint() noexcept 
+			{
+				thread_local Hint hint;
+				return hint;
+			}
+
+			template <class _Ty>
+			_NODISCARD _Ty* try_occupy(Hint& hint, size_t count, float load) noexcept
+			{
+				if (hint.myPage == nullptr || hint.myGeneration != myGeneration)
+					return nullptr;
+
+				auto& page = *hint.myPage;
+				auto  ptr  = page.template try_occupy_next<_Ty>(count, hint.myPageHint);
+
+				if (ptr == nullptr && page.load() + load <= page_type::max_load()) {
+					hint.myPageHint = page.template fit<_Ty>(count);
+					ptr = page.template try_occupy_next<_Ty>(count, hint.myPageHint);
+				}
+
+				if (ptr != nullptr)
+					rekey(page);
+
+				return ptr;
+			}
+
+			// Chunks are kept sorted by address, so a foreign pointer never gets its chunk header read
+			_NODISCARD bool owns(void const* data) const noexcept 
+			{
+				auto const chunk = std::addressof(chunk_of(data));
+
+				return std::binary_search(myChunks.begin(), myChunks.end(), chunk, std::less<>{}) && 
+					   page_of(data) != nullptr;
+			}
+
+			void remember(Hint& hint, void const* data) noexcept
+			{
+				hint.myPage		  = page_of(data);
+				hint.myPageHint	  = {};
+				hint.myGeneration = myGeneration;
+			}
+
+			template <class _Ty, class _OccupyTy>
+			_NODISCARD _Ty* occupy_aligned(size_t count, size_t alignment, Hint& hint) noexcept 
+			{
+				constexpr auto candidates = _OccupyTy::candidates;
+				constexpr auto growths	  = std::max<size_t>(_OccupyTy::growths, !_ThreadingTy::replenishing);
+
+				[[maybe_unused]] auto const started = Detail::probe_time(SEWEEX_MEMORY_PROBE_ENABLED(occupy));
+
+				if (is_large<_Ty>(count, alignment)) {
+					auto const ptr = count <= std::numeric_limits<size_t>::max() / sizeof(_Ty) ?
+									 static_cast<_Ty*>(occupy_large(sizeof(_Ty) * count, std::max(alignment, alignof(_Ty)))) :
+									 nullptr;
+
+					record_outcome(ptr != nullptr);
+
+					if (ptr != nullptr)
+						mySampler.occupied(ptr, sizeof(_Ty) * count);
+
+					SEWEEX_MEMORY_PROBE(occupy, sizeof(_Ty) * count, ptr, 0, Detail::probe_since(started));
+					return ptr;
+				}
+
+				auto const load  = page_type::template load_of<_Ty>(count);
+				auto const local = local_node();
+				_Ty* ptr = nullptr;
+
+				// Checked first, so that the shared line of the node is only read once the flag is set
+				if (!myNodes[local].demanded.load(std::memory_order_relaxed))
+					myNodes[local].demanded.store(true, std::memory_order_relaxed);
+
+				bool starving = false;
+
+				{
+					std::unique_lock lock{ myAllocateMutex };
+
+					if (alignment <= _Alignment)
+						ptr = try_occupy<_Ty>(hint, count, load);
+
+					if (ptr == nullptr) 
+					{
+						ptr = try_occupy<_Ty, candidates>(myNodes[local].pages, count, alignment, load);
+
+						for (unsigned node = 0; ptr == nullptr && node < myNodes.size(); ++node)
+							if (node != local)
+								ptr = try_occupy<_Ty, candidates>(myNodes[node].pages, count, alignment, load);
+
+						if (ptr != nullptr)
+							remember(hint, ptr);
+					}
+
+					auto const& pages = myNodes[local].pages;
+					starving = ptr == nullptr || pages.empty() || pages.begin()->first + load >= page_type::max_load();
+				}
+
+				if (starving)
+					wake_replenisher();
+
+				// A growth racing this one may have taken the last of a bounded capacity, its pages are still tried
+				for (size_t grown = 0; ptr == nullptr && grown < growths; ++grown)
+				{
+					bool exhausted = false;
+
+					try {
+						grow(1, local);
+					}
+					catch (...) {
+						exhausted = true;
+					}
+
+					{
+						std::unique_lock lock{ myAllocateMutex };
+						auto& pages = myNodes[local].pages;
+
+						if (!pages.empty())
+						{
+							auto& emptiest = *pages.begin()->second;
+
+							// More pages cannot help a request that not even an empty one fits
+							if ((ptr = try_occupy<_Ty>(emptiest, count, alignment)) != nullptr)
+								remember(hint, ptr);
+							else if (emptiest.empty())
+								exhausted = true;
+						}
+					}
+
+					if (exhausted)
+						break;
+				}
+
+				if constexpr (_ThreadingTy::replenishing)
+					record_request(load);
+
+				record_outcome(ptr != nullptr);
+
+				if (ptr != nullptr)
+					mySampler.occupied(ptr, sizeof(_Ty) * count);
+
+				SEWEEX_MEMORY_PROBE(occupy, sizeof(_Ty) * count, ptr, Detail::probe_load(load), Detail::probe_since(started));
 				return ptr;
 			}
 
-			// some methods hasn't been realized yet ...
+			_NODISCARD void* occupy_large(size_t bytes, size_t alignment) noexcept
+			{
+				auto const pageSize = Detail::system_page_size();
+
+				if (bytes > std::numeric_limits<size_t>::max() - pageSize)
+					return nullptr;
+
+				auto const length = (bytes + pageSize - 1) & ~(pageSize - 1);
+				auto const data   = Detail::map_memory(length, alignment);
+
+				if (data != nullptr)
+				{
+					try {
+						std::unique_lock lock{ myLargeMutex };
+						myLarge.emplace(reinterpret_cast<uintptr_t>(data), Large{ length, alignment });
+					}
+					catch (...) {
+						Detail::unmap_memory(data, length, alignment);
+						return nullptr;
+					}
+				}
+
+				return data;
+			}
+
+			bool release_large(void* data) noexcept
+			{
+				Large large;
+
+				{
+					std::unique_lock lock{ myLargeMutex };
+					auto const iter = myLarge.find(reinterpret_cast<uintptr_t>(data));
+
+					if (iter == myLarge.end())
+						return false;
+
+					large = iter->second;
+					myLarge.erase(iter);
+				}
+
+				Detail::unmap_memory(data, large.length, large.alignment);
+				notify_waiters();
+
+				return true;
+			}
+
+			_NODISCARD void* reallocate_large(void* data, size_t bytes) noexcept
+			{
+				auto const pageSize = Detail::system_page_size();
+				auto const length   = (bytes + pageSize - 1) & ~(pageSize - 1);
+
+				std::unique_lock lock{ myLargeMutex };
+				auto const iter = myLarge.find(reinterpret_cast<uintptr_t>(data));
+
+				if (iter == myLarge.end())
+					return nullptr;
+
+				auto const large = iter->second;
+
+				if (large.length == length)
+					return data;
+
+				auto const moved = Detail::remap_memory(data, large.length, length, large.alignment);
+
+				if (moved != nullptr) {
+					auto node = myLarge.extract(iter);
+
+					node.key()			  = reinterpret_cast<uintptr_t>(moved);
+					node.mapped().length  = length;
+
+					myLarge.insert(std::move(node));
+				}
+
+				return moved;
+			}
+
+			void record_outcome(bool succeeded) noexcept
+			{
+#if defined(SEWEEX_MEMORY_POOL_STATISTICS)
+				auto& shard = myRequests[Detail::thread_shard() % request_shards];
+
+				if (succeeded)
+					shard.succeeded.add();
+				else
+					shard.failed.add();
+#else
+				static_cast<void>(succeeded);
+#endif
+			}
+
+			void record_request(float load) noexcept
+			{
+				auto& shard = myRequests[Detail::thread_shard() % request_shards];
+
+				shard.load.fetch_add(static_cast<uint64_t>(load * request_scale), std::memory_order_relaxed);
+				shard.count.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			_NODISCARD float average_request_load() const noexcept
+			{
+				uint64_t load  = 0;
+				uint64_t count = 0;
+
+				for (auto const& shard : myRequests) {
+					load  += shard.load.load(std::memory_order_relaxed);
+					count += shard.count.load(std::memory_order_relaxed);
+				}
+
+				return count != 0 ? static_cast<float>(load) / request_scale / count : 0;
+			}
+
+			void pages_allocating_proc(std::stop_token stop) 
+			{
+				std::stop_callback stopping{ stop, [this] () noexcept {
+					{
+						std::lock_guard lock{ myReplenishMutex };
+					}
+
+					myReplenishCondition.notify_one();
+				} };
+
+				while (!stop.stop_requested())
+				{
+					constexpr auto maxLoad = page_type::max_load();
+
+					auto const averageLoad = average_request_load();
+					bool	   grown	   = false;
+
+					for (unsigned node = 0; node < myNodes.size(); ++node)
+					{
+						auto& [pages, demanded] = myNodes[node];
+						float maxPageLoad;
+
+						if (!demanded.load(std::memory_order_relaxed))
+							continue;
+
+						{
+							std::shared_lock lock{ myAllocateMutex };
+
+							auto const first = pages.begin();
+							maxPageLoad = first != pages.end() ? first->first : maxLoad;
+						}
+
+						SEWEEX_MEMORY_PROBE(replenish, node, Detail::probe_load(maxPageLoad), Detail::probe_load(averageLoad));
+
+						if (maxPageLoad + averageLoad >= maxLoad)
+							try {
+								make_pages(1, node);
+								grown = true;
+							}
+							catch (...) {}
+					}
+
+					notify_waiters(false);
+
+					if (!grown)
+					{
+						auto const deadline = next_deadline();
+						auto const ready	= [this, &stop] () noexcept {
+							return stop.stop_requested() || myReplenish.exchange(false, std::memory_order_acq_rel);
+						};
+
+						std::unique_lock lock{ myReplenishMutex };
+
+						if (deadline != std::chrono::steady_clock::time_point::max())
+							myReplenishCondition.wait_until(lock, deadline, ready);
+						else
+							myReplenishCondition.wait(lock, ready);
+					}
+				}
+			}
+
+			// The replenisher sleeps until an occupation runs short of pages, a waiter is queued or one expires
+			void wake_replenisher() noexcept
+			{
+				if constexpr (_ThreadingTy::replenishing)
+					if (!myReplenish.exchange(true, std::memory_order_acq_rel)) {
+						{
+							std::lock_guard lock{ myReplenishMutex };
+						}
+
+						myReplenishCondition.notify_one();
+					}
+			}
+
+			_NODISCARD std::chrono::steady_clock::time_point next_deadline() noexcept
+			{
+				auto deadline = std::chrono::steady_clock::time_point::max();
+
+				if (myWaiting.load(std::memory_order_relaxed) != 0)
+				{
+					std::unique_lock lock{ myWaitMutex };
+
+					for (auto waiter = myWaitHead; waiter != nullptr; waiter = waiter->next)
+						deadline = std::min(deadline, waiter->deadline);
+				}
+
+				return deadline;
+			}
+
+		public:
+			Pool (allocator_type const& alloc = allocator_type()) :
+				myPageAllocator (alloc),
+				myNodes			(alloc),
+				myChunks		(alloc),
+				myLarge			(alloc),
+				mySampler		(alloc)
+			{
+				for (unsigned node = 0; node < Detail::numa_nodes(); ++node)
+					myNodes.emplace_back(alloc);
+
+				myNodes[local_node()].demanded = true;
+
+				if constexpr (_ThreadingTy::replenishing)
+					myThread = std::jthread{ [this] (std::stop_token stop) { pages_allocating_proc(stop); } };
+			}
+
+			// Pages live in the file and outlive the pool, reopening it adopts every block occupied before.
+			// Large blocks get dedicated mappings and do not persist, the file grows up to `pages` pages.
+			// A foreign or differently laid out file throws, an unclean one throws unless `recovery` discards it
+			Pool (
+				std::filesystem::path const& path, 
+				size_t pages, 
+				Recovery recovery = Recovery::reject, 
+				allocator_type const& alloc = allocator_type()
+			) :
+				myPageAllocator (alloc),
+				myNodes			(alloc),
+				myChunks		(alloc),
+				myLarge			(alloc),
+				mySampler		(alloc),
+				myFile			(path)
+			{
+				for (unsigned node = 0; node < Detail::numa_nodes(); ++node)
+					myNodes.emplace_back(alloc);
+
+				myNodes[local_node()].demanded = true;
+
+				open(path, pages, recovery);
+
+				if constexpr (_ThreadingTy::replenishing)
+					myThread = std::jthread{ [this] (std::stop_token stop) { pages_allocating_proc(stop); } };
+			}
+
+			~Pool() noexcept 
+			{
+				if (myThread.joinable()) {
+					myThread.request_stop();
+					myThread.join();
+				}
+
+				while (myWaitHead != nullptr) {
+					auto& waiter = *myWaitHead;
+
+					unlink(waiter);
+					waiter.resume();
+				}
+
+				for (auto const chunk : myChunks)
+					drop(chunk);
+
+				for (auto const& [data, large] : myLarge)
+					Detail::unmap_memory(reinterpret_cast<void*>(data), large.length, large.alignment);
+
+				// The file is marked clean only once all of its pages are written back
+				if (myHeader != nullptr) {
+					myFile.sync((myHeader->chunks + 1) * sizeof(chunk_type));
+					myHeader->clean = 1;
+					myFile.sync(sizeof(Detail::PersistentHeader));
+				}
+			}
+
+			_NODISCARD page_allocator_type get_allocator() const noexcept {
+				return myPageAllocator;
+			}
+
+			_NODISCARD unsigned nodes() const noexcept {
+				return static_cast<unsigned>(myNodes.size());
+			}
+
+			void make_pages(size_t count) {
+				make_pages(count, local_node());
+			}
+
+			void make_pages(size_t count, unsigned node) {
+				grow(count, node);
+				notify_waiters();
+			}
+
+			size_t trim() noexcept
+			{
+				std::unique_lock lock{ myAllocateMutex };
+				std::unique_lock fileLock{ myFileMutex, std::defer_lock };
+
+				size_t persistent = 0;
+				size_t kept		  = 0;
+
+				// Only the empty tail of the file can go, and only once every claimed chunk has been merged
+				if (myHeader != nullptr) 
+				{
+					fileLock.lock();
+					persistent = kept = myHeader->chunks;
+
+					auto const first = std::lower_bound(myChunks.begin(), myChunks.end(), persistent_chunk(0), std::less<>{});
+					auto const last	 = std::lower_bound(first, myChunks.end(), persistent_chunk(persistent), std::less<>{});
+
+					if (static_cast<size_t>(last - first) == persistent)
+						while (kept != 0 && is_empty(*persistent_chunk(kept - 1)))
+							--kept;
+				}
+
+				// Chunks are dropped as they are visited, removing in place keeps the order without a temporary buffer
+				auto const used = std::remove_if(myChunks.begin(), myChunks.end(), [this, kept] (chunk_type* chunk) noexcept 
+				{
+					if (is_persistent(chunk) ? std::less<>{}(chunk, persistent_chunk(kept)) : !is_empty(*chunk))
+						return false;
+
+					for (auto& slot : chunk->slots)
+						myNodes[slot.node].pages.erase(slot.where);
+
+					drop(chunk);
+					return true;
+				});
+
+				auto const trimmed = static_cast<size_t>(myChunks.end() - used);
+
+				myChunks.erase(used, myChunks.end());
+
+				if (kept != persistent)
+					try {
+						myHeader->chunks = kept;
+						myFile.resize((kept + 1) * sizeof(chunk_type));
+					}
+					catch (...) {}
+
+				if (trimmed != 0) {
+					myGeneration = Detail::next_generation();
+					myTrims.add();
+				}
+
+				SEWEEX_MEMORY_PROBE(trim, trimmed * chunk_pages, myChunks.size() * chunk_pages);
+
+				return trimmed * chunk_pages;
+			}
+
+			// The root block of a persistent pool is found again after reopening, other pools have none
+			_NODISCARD void* root() const noexcept {
+				return myHeader != nullptr && myHeader->root != 0 ? myFile.data() + myHeader->root : nullptr;
+			}
+
+			void root(void const* data) noexcept
+			{
+				if (myHeader != nullptr)
+					myHeader->root = myFile.contains(data) ? static_cast<std::byte const*>(data) - myFile.data() : 0;
+			}
+
+			// How far the file moved since it was closed, pointers stored in it are off by this much when not zero
+			_NODISCARD ptrdiff_t relocation() const noexcept {
+				return myRelocation;
+			}
+
+			// Samples roughly one occupation per `bytes` occupied, zero stops sampling
+			void sample_heap_every(size_t bytes) noexcept {
+				mySampler.rate(bytes);
+			}
+
+			// Writes live samples in the legacy heap profile format understood by pprof
+			void dump_heap_profile(std::ostream& stream) const {
+				mySampler.dump(stream);
+			}
+
+			_NODISCARD PoolStatistics stats() const
+			{
+				PoolStatistics result;
+
+				{
+					std::shared_lock lock{ myAllocateMutex };
+
+					result.chunks		   = myChunks.size();
+					result.pages		   = myChunks.size() * chunk_pages;
+					result.committed_bytes = myChunks.size() * sizeof(chunk_type);
+					result.metadata_bytes  = result.committed_bytes - result.pages * _Size;
+
+					for (auto const chunk : myChunks)
+						for (auto const& page : chunk->pages) 
+						{
+							auto const bucket = static_cast<size_t>(page.load() * result.load_histogram.size());
+
+							result.occupied_bytes  += page.occupied();
+							result.largest_free_run = std::max(result.largest_free_run, page.largest_free());
+
+							++result.load_histogram[std::min(bucket, result.load_histogram.size() - 1)];
+						}
+				}
+
+				{
+					std::shared_lock lock{ myLargeMutex };
+
+					result.large_allocations = myLarge.size();
+
+					for (auto const& [data, large] : myLarge)
+						result.large_bytes += large.length;
+
+					result.committed_bytes += result.large_bytes;
+				}
+
+				for (auto const& shard : myRequests) {
+					result.occupy_succeeded += shard.succeeded.value();
+					result.occupy_failed	+= shard.failed.value();
+				}
+
+				result.growth_events = myGrowths.value();
+				result.trim_events	 = myTrims.value();
+
+				return result;
+			}
+
+			template <class _Ty, Detail::OccupyPolicy _OccupyTy = Occupy::Fast>
+			_NODISCARD _Ty* occupy(size_t count, _OccupyTy = {}) noexcept {
+				return occupy_aligned<_Ty, _OccupyTy>(count, alignment_of<_Ty>, thread_hint());
+			}
+
+			// Serves streams of allocations from the hinted page and position while they fit, the hint follows the stream
+			template <class _Ty, Detail::OccupyPolicy _OccupyTy = Occupy::Fast>
+			_NODISCARD _Ty* occupy(size_t count, Hint& hint, _OccupyTy = {}) noexcept {
+				return occupy_aligned<_Ty, _OccupyTy>(count, alignment_of<_Ty>, hint);
+			}
+
+			// Prefers the page holding `near`, pointers from other pools or dedicated mappings just take the usual way
+			template <class _Ty, Detail::OccupyPolicy _OccupyTy = Occupy::Fast>
+			_NODISCARD _Ty* occupy_near(void const* near, size_t count, _OccupyTy = {}) noexcept 
+			{
+				Hint hint;
+
+				if (near != nullptr)
+				{
+					std::shared_lock lock{ myAllocateMutex };
+
+					if (owns(near))
+						remember(hint, near);
+				}
+
+				return occupy_aligned<_Ty, _OccupyTy>(count, alignment_of<_Ty>, hint);
+			}
+
+			// Alignments above the page alignment are carved out of pages, or mapped when a page cannot hold them
+			template <Detail::OccupyPolicy _OccupyTy = Occupy::Fast>
+			_NODISCARD void* occupy_bytes(size_t bytes, size_t alignment, _OccupyTy = {}) noexcept 
+			{
+				if (!std::has_single_bit(alignment))
+					return nullptr;
+
+				return occupy_aligned<std::byte, _OccupyTy>(bytes, alignment, thread_hint());
+			}
+
+			// Queues the waiter unless its memory is available right away or it was cancelled before, the result tells which
+			_NODISCARD bool enqueue(Detail::OccupyWaiter& waiter) noexcept
+			{
+				std::unique_lock lock{ myWaitMutex };
+
+				if (waiter.cancelled || std::chrono::steady_clock::now() >= waiter.deadline)
+					return false;
+
+				myWaiting.fetch_add(1, std::memory_order_relaxed);
+
+				if ((waiter.result = occupy_bytes(waiter.bytes, waiter.alignment)) != nullptr) {
+					myWaiting.fetch_sub(1, std::memory_order_relaxed);
+					return false;
+				}
+
+				link(waiter);
+				lock.unlock();
+
+				wake_replenisher();
+				return true;
+			}
+
+			// Resumes a queued waiter empty handed, or keeps a waiter that is not queued yet from being queued
+			void cancel(Detail::OccupyWaiter& waiter) noexcept
+			{
+				{
+					std::unique_lock lock{ myWaitMutex };
+
+					if (!waiter.queued) {
+						waiter.cancelled = true;
+						return;
+					}
+
+					unlink(waiter);
+				}
+
+				waiter.resume();
+			}
+
+			// Only valid for pointers served from pages, not from dedicated mappings
+			_NODISCARD static Pool& owner_of(void const* data) noexcept {
+				return *chunk_of(data).owner;
+			}
+
+			template <class _Ty>
+			bool release(_Ty* ptr, size_t count) noexcept
+			{
+				if (ptr == nullptr)
+					return false;
+
+				SEWEEX_MEMORY_PROBE(release, sizeof(_Ty) * count, ptr);
+				mySampler.released(ptr);
+
+				if (is_large<_Ty>(count))
+					return release_large(ptr);
+
+				auto const page = page_of(ptr);
+
+				if (page == nullptr)
+					return false;
+
+				{
+					std::unique_lock lock{ myAllocateMutex };
+
+					if (!release_in(*page, ptr, count))
+						return false;
+
+					rekey(*page);
+				}
+
+				notify_waiters();
+				return true;
+			}
+
+			bool release_bytes(void* ptr, size_t bytes, size_t alignment) noexcept
+			{
+				if (ptr != nullptr && alignment > _Alignment && is_large<std::byte>(bytes, alignment)) {
+					SEWEEX_MEMORY_PROBE(release, bytes, ptr);
+					mySampler.released(ptr);
+
+					return release_large(ptr);
+				}
+
+				return release(static_cast<std::byte*>(ptr), bytes);
+			}
+
+			// Blocks sorted by address let every page of the batch be re-keyed once under a single lock
+			size_t release_batch(std::span<std::pair<void*, size_t> const> blocks) noexcept
+			{
+				size_t released = 0;
+
+				for (auto const& [ptr, bytes] : blocks)
+				{
+					if (ptr != nullptr) {
+						SEWEEX_MEMORY_PROBE(release, bytes, ptr);
+						mySampler.released(ptr);
+					}
+				}
+
+				{
+					std::unique_lock lock{ myAllocateMutex };
+					page_type* current = nullptr;
+
+					for (auto const& [ptr, bytes] : blocks)
+					{
+						if (ptr == nullptr || is_large<std::byte>(bytes))
+							continue;
+
+						auto const page = page_of(ptr);
+
+						if (page == nullptr)
+							continue;
+
+						if (page != current && current != nullptr)
+							rekey(*current);
+
+						current   = page;
+						released += page->release(static_cast<std::byte*>(ptr), bytes);
+					}
+
+					if (current != nullptr)
+						rekey(*current);
+				}
+
+				for (auto const& [ptr, bytes] : blocks)
+				{
+					if (ptr == nullptr || !is_large<std::byte>(bytes))
+						continue;
+
+					released += release_large(ptr);
+				}
+
+				notify_waiters();
+				return released;
+			}
+
+			template <class _Ty, Detail::OccupyPolicy _OccupyTy = Occupy::Fast>
+			requires (std::is_trivially_copyable_v<_Ty>)
+			_NODISCARD _Ty* reallocate(_Ty* ptr, size_t count, size_t newCount, _OccupyTy policy = {}) noexcept
+			{
+				if (ptr == nullptr)
+					return occupy<_Ty>(newCount, policy);
+
+				if (is_large<_Ty>(count) && is_large<_Ty>(newCount))
+					if (auto const moved = reallocate_large(ptr, sizeof(_Ty) * newCount)) {
+						mySampler.released(ptr);
+						mySampler.occupied(moved, sizeof(_Ty) * newCount);
+
+						return static_cast<_Ty*>(moved);
+					}
+
+				if (!is_large<_Ty>(count) && !is_large<_Ty>(newCount))
+					if (auto const page = page_of(ptr))
+					{
+						_Ty* moved = nullptr;
+
+						{
+							std::unique_lock lock{ myAllocateMutex };
+
+							if (resize_in(*page, ptr, count, newCount))
+								moved = ptr;
+							else if ((moved = try_occupy<_Ty>(*page, newCount, alignment_of<_Ty>)) != nullptr) {
+								Detail::copy_aligned<_Alignment>(moved, ptr, sizeof(_Ty) * std::min(count, newCount));
+								release_in(*page, ptr, count);
+							}
+
+							if (moved != nullptr)
+								rekey(*page);
+						}
+
+						if (moved != nullptr) 
+						{
+							if (moved != ptr) {
+								mySampler.released(ptr);
+								mySampler.occupied(moved, sizeof(_Ty) * newCount);
+							}
+
+							if (moved != ptr || newCount < count)
+								notify_waiters();
+
+							return moved;
+						}
+					}
+
+				auto const fresh = occupy<_Ty>(newCount, policy);
+
+				if (fresh != nullptr) {
+					Detail::copy_aligned<_Alignment>(fresh, ptr, sizeof(_Ty) * std::min(count, newCount));
+					release(ptr, count);
+				}
+
+				return fresh;
+			}
 
 		private:
-			std::multimap <float, std::unique_ptr<page_type>> myPages;
+			page_allocator_type					myPageAllocator;
+			std::deque<Node, rebind_type<Node>> myNodes;
+			chunks_type							myChunks;
+			large_type							myLarge;
+
+			mutable typename _ThreadingTy::mutex_type myAllocateMutex;
+			mutable typename _ThreadingTy::mutex_type myLargeMutex;
+
+			std::array<RequestShard, request_shards> myRequests;
+
+			[[no_unique_address]] Detail::EventCounter<_ThreadingTy> myGrowths;
+			[[no_unique_address]] Detail::EventCounter<_ThreadingTy> myTrims;
+
+			[[no_unique_address]] Detail::HeapSampler<_AllocTy, _ThreadingTy> mySampler;
+
+			uint64_t myGeneration = Detail::next_generation();
+
+			typename _ThreadingTy::mutex_type					myWaitMutex;
+			typename _ThreadingTy::template atomic_type<size_t> myWaiting  = 0;
+			Detail::OccupyWaiter*								myWaitHead = nullptr;
+			Detail::OccupyWaiter*								myWaitTail = nullptr;
+
+			Detail::MappedFile				  myFile;
+			Detail::PersistentHeader*		  myHeader	   = nullptr;
+			ptrdiff_t						  myRelocation = 0;
+			typename _ThreadingTy::mutex_type myFileMutex;
+			typename _ThreadingTy::mutex_type myGrowthMutex;
 
-			std::jthread      myThread;
-			std::shared_mutex myAllocateMutex;
-			std::shared_mutex myReserveMutex;
+			std::mutex											myReplenishMutex;
+			std::condition_variable								myReplenishCondition;
+			typename _ThreadingTy::template atomic_type<bool>	myReplenish = false;
 
-			float  myAverageLoadRequest = 0;
-			size_t myRequestsCount		= 0;
+			std::jthread myThread;
 		};
 	}
 }
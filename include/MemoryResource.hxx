@@ -0,0 +1,57 @@
+#ifndef SEWEEX_MEMORY_RESOURCE
+#define SEWEEX_MEMORY_RESOURCE
+
+#include "Memory.hxx"
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace Seweex
+{
+	namespace Memory
+	{
+		template <class _PoolTy>
+		class PoolResource final : public std::pmr::memory_resource
+		{
+		public:
+			using pool_type = _PoolTy;
+
+			PoolResource (pool_type& pool) noexcept :
+				myPool (std::addressof(pool))
+			{}
+
+			PoolResource(PoolResource const&) = delete;
+			PoolResource& operator=(PoolResource const&) = delete;
+
+			_NODISCARD pool_type& pool() const noexcept {
+				return *myPool;
+			}
+
+		private:
+			// Over-aligned requests are served by the pool as well, carved out of a page or mapped on their own
+			void* do_allocate(size_t bytes, size_t alignment) override
+			{
+				auto const data = myPool->occupy_bytes(bytes, alignment, Occupy::Bounded<>{});
+
+				if (data == nullptr)
+					throw std::bad_alloc{};
+
+				return data;
+			}
+
+			void do_deallocate(void* data, size_t bytes, size_t alignment) override {
+				myPool->release_bytes(data, bytes, alignment);
+			}
+
+			_NODISCARD bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+			{
+				auto const resource = dynamic_cast<PoolResource const*>(std::addressof(other));
+				return resource != nullptr && resource->myPool == myPool;
+			}
+
+			pool_type* myPool;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef SEWEEX_MEMORY_OBJECT_POOL
+#define SEWEEX_MEMORY_OBJECT_POOL
+
+#include "Memory.hxx"
+
+#include <new>
+#include <memory>
+#include <utility>
+
+namespace Seweex
+{
+	namespace Memory
+	{
+		template <class _Ty, class _PoolTy>
+		struct PooledDelete
+		{
+			void operator()(_Ty* ptr) const noexcept
+			{
+				if (ptr != nullptr) {
+					std::destroy_at(ptr);
+					_PoolTy::owner_of(ptr).release(ptr, 1);
+				}
+			}
+		};
+
+		template <class _Ty, class _PoolTy>
+		using Pooled = std::unique_ptr<_Ty, PooledDelete<_Ty, _PoolTy>>;
+
+		template <class _Ty, class _PoolTy, class... _ArgsTy>
+		_NODISCARD Pooled<_Ty, _PoolTy> make_pooled(_PoolTy& pool, _ArgsTy&&... args)
+		{
+			static_assert(alignof(_Ty) <= _PoolTy::page_alignment, "the pool's pages cannot align this type");
+			static_assert(sizeof(_Ty) <= _PoolTy::page_size, "pooled objects must fit into one page");
+
+			auto const data = pool.template occupy<_Ty>(1, Occupy::Bounded<>{});
+
+			if (data == nullptr)
+				throw std::bad_alloc{};
+
+			try {
+				return Pooled<_Ty, _PoolTy>{ std::construct_at(data, std::forward<_ArgsTy>(args)...) };
+			}
+			catch (...) {
+				pool.release(data, 1);
+				throw;
+			}
+		}
+
+		template <class _Ty, class _PoolTy>
+		class ObjectPool final
+		{
+		public:
+			using value_type = _Ty;
+			using pool_type  = _PoolTy;
+			using pointer	 = Pooled<_Ty, _PoolTy>;
+
+			ObjectPool (pool_type& pool) noexcept :
+				myPool (std::addressof(pool))
+			{}
+
+			template <class... _ArgsTy>
+			_NODISCARD pointer make(_ArgsTy&&... args) {
+				return make_pooled<_Ty>(*myPool, std::forward<_ArgsTy>(args)...);
+			}
+
+			_NODISCARD pool_type& pool() const noexcept {
+				return *myPool;
+			}
+
+		private:
+			pool_type* myPool;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef SEWEEX_MEMORY_POOL_ALLOCATOR
+#define SEWEEX_MEMORY_POOL_ALLOCATOR
+
+#include "Memory.hxx"
+
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+namespace Seweex
+{
+	namespace Memory
+	{
+		template <class _Ty, class _PoolTy>
+		class PoolAllocator
+		{
+			template <class, class>
+			friend class PoolAllocator;
+
+		public:
+			using value_type = _Ty;
+			using pool_type  = _PoolTy;
+
+			using propagate_on_container_copy_assignment = std::true_type;
+			using propagate_on_container_move_assignment = std::true_type;
+			using propagate_on_container_swap			 = std::true_type;
+			using is_always_equal						 = std::false_type;
+
+			constexpr PoolAllocator (pool_type& pool) noexcept :
+				myPool (std::addressof(pool))
+			{}
+
+			template <class _OtherTy>
+			constexpr PoolAllocator (PoolAllocator<_OtherTy, _PoolTy> const& other) noexcept :
+				myPool (other.myPool)
+			{}
+
+			constexpr PoolAllocator(PoolAllocator&&)      noexcept = default;
+			constexpr PoolAllocator(PoolAllocator const&) noexcept = default;
+
+			constexpr PoolAllocator& operator=(PoolAllocator&&)      noexcept = default;
+			constexpr PoolAllocator& operator=(PoolAllocator const&) noexcept = default;
+
+			_NODISCARD _Ty* allocate(size_t count)
+			{
+				static_assert(alignof(_Ty) <= pool_type::page_alignment, "the pool's pages cannot align this type");
+
+				auto const data = myPool->template occupy<_Ty>(count, Occupy::Bounded<>{});
+
+				if (data == nullptr)
+					throw std::bad_alloc{};
+
+				return data;
+			}
+
+			void deallocate(_Ty* data, size_t count) noexcept {
+				myPool->release(data, count);
+			}
+
+			_NODISCARD constexpr pool_type& pool() const noexcept {
+				return *myPool;
+			}
+
+			template <class _OtherTy>
+			_NODISCARD constexpr bool operator==(PoolAllocator<_OtherTy, _PoolTy> const& other) const noexcept {
+				return myPool == other.myPool;
+			}
+
+		private:
+			pool_type* myPool;
+		};
+
+		template <class _Ty, class _PoolTy, class... _ArgsTy>
+		_NODISCARD std::shared_ptr<_Ty> allocate_pooled_shared(_PoolTy& pool, _ArgsTy&&... args) {
+			return std::allocate_shared<_Ty>(PoolAllocator<_Ty, _PoolTy>{ pool }, std::forward<_ArgsTy>(args)...);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,368 @@
+#ifndef SEWEEX_MEMORY_RECLAMATION
+#define SEWEEX_MEMORY_RECLAMATION
+
+#include "Memory.hxx"
+
+#include <span>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+namespace Seweex
+{
+	namespace Detail
+	{
+		inline constexpr size_t retired_batch = 64;
+
+		struct Retired final
+		{
+			void (*destroy) (void*, size_t) noexcept;
+			size_t count;
+		};
+
+		template <class _Ty>
+		void destroy_retired(void* data, size_t count) noexcept {
+			std::destroy_n(static_cast<_Ty*>(data), count);
+		}
+
+		// The epoch is the one observed when the batch was sealed, no block in it was retired later
+		struct RetiredBatch final
+		{
+			RetiredBatch* next  = nullptr;
+			uint64_t	  epoch = 0;
+			size_t		  size  = 0;
+
+			std::array<std::pair<void*, size_t>, retired_batch> blocks;
+			std::array<Retired, retired_batch>					retired;
+		};
+
+		// The low bit of the state marks a pinned participant, the rest is the epoch it observed
+		struct alignas(cache_line) EpochRecord final
+		{
+			std::atomic<uint64_t> state = 0;
+			std::atomic<bool>	  taken = true;
+			EpochRecord*		  next	= nullptr;
+		};
+	}
+
+	namespace Memory
+	{
+		template <class _PoolTy>
+		class EpochDomain final
+		{
+			using allocator_traits = std::allocator_traits<std::remove_cvref_t<decltype(std::declval<_PoolTy const&>().get_allocator())>>;
+
+			using batch_allocator  = typename allocator_traits::template rebind_alloc<Detail::RetiredBatch>;
+			using record_allocator = typename allocator_traits::template rebind_alloc<Detail::EpochRecord>;
+
+			using batch_traits	= std::allocator_traits<batch_allocator>;
+			using record_traits = std::allocator_traits<record_allocator>;
+
+			_NODISCARD Detail::EpochRecord& acquire()
+			{
+				for (auto record = myRecords.load(std::memory_order_acquire); record != nullptr; record = record->next)
+				{
+					bool taken = false;
+
+					if (record->taken.compare_exchange_strong(taken, true, std::memory_order_acquire))
+						return *record;
+				}
+
+				auto record = record_traits::allocate(myRecordAllocator, 1);
+				record_traits::construct(myRecordAllocator, record);
+
+				record->next = myRecords.load(std::memory_order_relaxed);
+
+				while (!myRecords.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed));
+
+				return *record;
+			}
+
+			// Every pinned participant has to observe the current epoch before it may move on
+			bool try_advance() noexcept
+			{
+				auto epoch = myEpoch.load();
+
+				for (auto record = myRecords.load(std::memory_order_acquire); record != nullptr; record = record->next)
+				{
+					auto const state = record->state.load();
+
+					if ((state & 1) != 0 && (state >> 1) != epoch)
+						return false;
+				}
+
+				return myEpoch.compare_exchange_strong(epoch, epoch + 1);
+			}
+
+			_NODISCARD bool expired(Detail::RetiredBatch const& batch) const noexcept {
+				return batch.epoch + 2 <= myEpoch.load();
+			}
+
+			size_t free(Detail::RetiredBatch* batch) noexcept
+			{
+				auto const blocks = std::span{ batch->blocks.data(), batch->size };
+
+				for (size_t i = 0; i < batch->size; ++i) {
+					if (batch->retired[i].destroy != nullptr)
+						batch->retired[i].destroy(blocks[i].first, batch->retired[i].count);
+				}
+
+				std::sort(blocks.begin(), blocks.end());
+				auto const released = myPool->release_batch(blocks);
+
+				batch_traits::destroy(myBatchAllocator, batch);
+				batch_traits::deallocate(myBatchAllocator, batch, 1);
+
+				return released;
+			}
+
+			// Orphaned batches come from participants of any epoch, so the whole list is walked
+			size_t reclaim_orphans() noexcept
+			{
+				std::unique_lock lock{ myOrphanMutex, std::try_to_lock };
+
+				if (!lock.owns_lock())
+					return 0;
+
+				size_t released = 0;
+
+				for (auto link = std::addressof(myOrphans); *link != nullptr;)
+				{
+					if (auto const batch = *link; expired(*batch)) {
+						*link	  = batch->next;
+						released += free(batch);
+					}
+					else
+						link = std::addressof(batch->next);
+				}
+
+				return released;
+			}
+
+		public:
+			using pool_type = _PoolTy;
+
+			class Participant;
+
+			class Guard final
+			{
+			public:
+				Guard (Participant& participant) noexcept :
+					myParticipant (participant)
+				{
+					myParticipant.enter();
+				}
+
+				Guard(Guard&&)		= delete;
+				Guard(Guard const&) = delete;
+
+				Guard& operator=(Guard&&)	   = delete;
+				Guard& operator=(Guard const&) = delete;
+
+				~Guard() noexcept {
+					myParticipant.leave();
+				}
+
+			private:
+				Participant& myParticipant;
+			};
+
+			class Participant final
+			{
+				void seal() noexcept
+				{
+					if (myOpen == nullptr)
+						return;
+
+					myOpen->epoch = myDomain->myEpoch.load();
+
+					if (myNewest != nullptr)
+						myNewest->next = myOpen;
+					else
+						myOldest = myOpen;
+
+					myNewest = std::exchange(myOpen, nullptr);
+				}
+
+			private:
+				friend class EpochDomain;
+
+				Participant (EpochDomain& domain) :
+					myDomain (std::addressof(domain)),
+					myRecord (std::addressof(domain.acquire()))
+				{}
+
+			public:
+				Participant(Participant&&)		= delete;
+				Participant(Participant const&) = delete;
+
+				Participant& operator=(Participant&&)	   = delete;
+				Participant& operator=(Participant const&) = delete;
+
+				// Leftover batches are handed to the domain, a later participant or the domain itself frees them
+				~Participant() noexcept
+				{
+					seal();
+					reclaim();
+
+					myRecord->state.store(0, std::memory_order_release);
+					myRecord->taken.store(false, std::memory_order_release);
+
+					if (myOldest != nullptr)
+					{
+						std::unique_lock lock{ myDomain->myOrphanMutex };
+
+						myNewest->next		= myDomain->myOrphans;
+						myDomain->myOrphans = myOldest;
+					}
+				}
+
+				// Pins may nest, only the outermost one publishes the epoch
+				void enter() noexcept
+				{
+					if (myDepth++ == 0) {
+						myRecord->state.store(myDomain->myEpoch.load() << 1 | 1);
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+					}
+				}
+
+				void leave() noexcept
+				{
+					if (--myDepth == 0)
+						myRecord->state.store(0, std::memory_order_release);
+				}
+
+				_NODISCARD Guard pin() noexcept {
+					return { *this };
+				}
+
+				// The block is destroyed and released once no pinned participant can still reach it
+				template <class _Ty>
+				void retire(_Ty* ptr, size_t count = 1)
+				{
+					static_assert(alignof(_Ty) <= pool_type::page_alignment, "Retired blocks must come from the typed pool occupation");
+
+					if (ptr == nullptr)
+						return;
+
+					if (myOpen == nullptr) {
+						myOpen = batch_traits::allocate(myDomain->myBatchAllocator, 1);
+						batch_traits::construct(myDomain->myBatchAllocator, myOpen);
+					}
+
+					myOpen->blocks[myOpen->size]	= { ptr, sizeof(_Ty) * count };
+					myOpen->retired[myOpen->size++] = { std::is_trivially_destructible_v<_Ty> ? nullptr : &Detail::destroy_retired<_Ty>, count };
+
+					if (myOpen->size == Detail::retired_batch) {
+						seal();
+						reclaim();
+					}
+				}
+
+				// Seals the partly filled batch too, so that everything retired so far becomes eligible
+				size_t flush() noexcept
+				{
+					seal();
+					return reclaim();
+				}
+
+				size_t reclaim() noexcept
+				{
+					myDomain->try_advance();
+
+					size_t released = 0;
+
+					while (myOldest != nullptr && myDomain->expired(*myOldest))
+					{
+						auto const batch = std::exchange(myOldest, myOldest->next);
+						released += myDomain->free(batch);
+					}
+
+					if (myOldest == nullptr)
+						myNewest = nullptr;
+
+					return released + myDomain->reclaim_orphans();
+				}
+
+				_NODISCARD size_t pending() const noexcept
+				{
+					size_t count = myOpen != nullptr ? myOpen->size : 0;
+
+					for (auto batch = myOldest; batch != nullptr; batch = batch->next)
+						count += batch->size;
+
+					return count;
+				}
+
+			private:
+				EpochDomain*		 myDomain;
+				Detail::EpochRecord* myRecord;
+				size_t				 myDepth = 0;
+
+				Detail::RetiredBatch* myOpen   = nullptr;
+				Detail::RetiredBatch* myOldest = nullptr;
+				Detail::RetiredBatch* myNewest = nullptr;
+			};
+
+			EpochDomain (pool_type& pool) :
+				myPool			  (std::addressof(pool)),
+				myBatchAllocator  (pool.get_allocator()),
+				myRecordAllocator (pool.get_allocator())
+			{}
+
+			EpochDomain(EpochDomain&&)		= delete;
+			EpochDomain(EpochDomain const&) = delete;
+
+			EpochDomain& operator=(EpochDomain&&)	   = delete;
+			EpochDomain& operator=(EpochDomain const&) = delete;
+
+			// Participants must be gone by now, so whatever they left behind is unreachable
+			~EpochDomain() noexcept
+			{
+				while (myOrphans != nullptr)
+					free(std::exchange(myOrphans, myOrphans->next));
+
+				for (auto record = myRecords.load(); record != nullptr;)
+				{
+					auto const next = record->next;
+
+					record_traits::destroy(myRecordAllocator, record);
+					record_traits::deallocate(myRecordAllocator, record, 1);
+
+					record = next;
+				}
+			}
+
+			// One participant per thread, it must not outlive the domain
+			_NODISCARD Participant attach() {
+				return { *this };
+			}
+
+			_NODISCARD uint64_t epoch() const noexcept {
+				return myEpoch.load(std::memory_order_relaxed);
+			}
+
+			_NODISCARD pool_type& pool() const noexcept {
+				return *myPool;
+			}
+
+		private:
+			pool_type* myPool;
+
+			std::atomic<uint64_t>			  myEpoch	= 0;
+			std::atomic<Detail::EpochRecord*> myRecords = nullptr;
+
+			std::mutex			  myOrphanMutex;
+			Detail::RetiredBatch* myOrphans = nullptr;
+
+			[[no_unique_address]] batch_allocator  myBatchAllocator;
+			[[no_unique_address]] record_allocator myRecordAllocator;
+		};
+	}
+}
+
+#endif
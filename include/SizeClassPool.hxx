@@ -0,0 +1,160 @@
+#ifndef SEWEEX_MEMORY_SIZE_CLASS_POOL
+#define SEWEEX_MEMORY_SIZE_CLASS_POOL
+
+#include "Memory.hxx"
+
+#include <tuple>
+#include <cstddef>
+#include <utility>
+
+namespace Seweex
+{
+	namespace Detail
+	{
+		struct SizeClass final
+		{
+			size_t alignment;
+			size_t page_size;
+			size_t max_size;
+		};
+
+		inline constexpr size_t size_class_base   = 8;
+		inline constexpr size_t size_class_blocks = 8;
+		inline constexpr size_t size_class_page   = 512;
+
+		template <size_t _Count>
+		_NODISCARD consteval std::array<SizeClass, _Count> make_size_classes() noexcept
+		{
+			std::array<SizeClass, _Count> classes;
+
+			for (size_t i = 0; i < _Count; ++i) {
+				auto const alignment = size_class_base << i;
+				classes[i] = { alignment, alignment * size_class_page, alignment * size_class_blocks };
+			}
+
+			return classes;
+		}
+	}
+
+	namespace Memory
+	{
+		template <
+			size_t _Classes = 8,
+			Detail::Allocator _AllocTy = std::allocator <std::byte>,
+			class _ThreadingTy = Threading::Blocking
+		>
+		requires (_Classes > 0 && _Classes < 32)
+		class SizeClassPool final
+		{
+		public:
+			static constexpr auto classes = Detail::make_size_classes<_Classes>();
+
+		private:
+			template <size_t _Index>
+			using pool_at = Pool<classes[_Index].page_size, classes[_Index].alignment, _AllocTy, _ThreadingTy>;
+
+			template <class _Sequence>
+			struct pools_of;
+
+			template <size_t... _Indices>
+			struct pools_of <std::index_sequence<_Indices...>> final {
+				using type = std::tuple<pool_at<_Indices>...>;
+			};
+
+			using pools_type = typename pools_of<std::make_index_sequence<_Classes>>::type;
+
+			using occupy_proc  = void* (*) (SizeClassPool&, size_t, size_t) noexcept;
+			using release_proc = bool  (*) (SizeClassPool&, void*, size_t, size_t) noexcept;
+
+			template <size_t _Index, class _OccupyTy>
+			_NODISCARD static void* occupy_in(SizeClassPool& self, size_t bytes, size_t alignment) noexcept {
+				return std::get<_Index>(self.myPools).occupy_bytes(bytes, alignment, _OccupyTy{});
+			}
+
+			template <size_t _Index>
+			static bool release_in(SizeClassPool& self, void* ptr, size_t bytes, size_t alignment) noexcept {
+				return std::get<_Index>(self.myPools).release_bytes(ptr, bytes, alignment);
+			}
+
+			template <class _OccupyTy, size_t... _Indices>
+			_NODISCARD static consteval auto make_occupiers(std::index_sequence<_Indices...>) noexcept {
+				return std::array<occupy_proc, _Classes>{ &occupy_in<_Indices, _OccupyTy>... };
+			}
+
+			template <size_t... _Indices>
+			_NODISCARD static consteval auto make_releasers(std::index_sequence<_Indices...>) noexcept {
+				return std::array<release_proc, _Classes>{ &release_in<_Indices>... };
+			}
+
+			template <class _OccupyTy>
+			static constexpr auto occupiers = make_occupiers<_OccupyTy>(std::make_index_sequence<_Classes>{});
+
+			static constexpr auto releasers = make_releasers(std::make_index_sequence<_Classes>{});
+
+			template <size_t... _Indices>
+			SizeClassPool (_AllocTy const& alloc, std::index_sequence<_Indices...>) :
+				myPools (typename pool_at<_Indices>::allocator_type(alloc)...)
+			{}
+
+		public:
+			SizeClassPool (_AllocTy const& alloc = _AllocTy()) :
+				SizeClassPool (alloc, std::make_index_sequence<_Classes>{})
+			{}
+
+			SizeClassPool(SizeClassPool&&)	    = delete;
+			SizeClassPool(SizeClassPool const&) = delete;
+
+			SizeClassPool& operator=(SizeClassPool&&)      = delete;
+			SizeClassPool& operator=(SizeClassPool const&) = delete;
+
+			// Both bounds double from one class to the next, so the first class fixes the shifts for all of them
+			_NODISCARD static constexpr size_t class_of(size_t bytes, size_t alignment) noexcept
+			{
+				constexpr auto shift = std::countr_zero(classes.front().max_size);
+				constexpr auto base  = std::countr_zero(classes.front().alignment);
+
+				auto const bySize	   = static_cast<size_t>(std::bit_width((bytes - (bytes != 0)) >> shift));
+				auto const byAlignment = static_cast<size_t>(std::max(std::countr_zero(alignment), base) - base);
+
+				return std::min(std::max(bySize, byAlignment), _Classes - 1);
+			}
+
+			template <Detail::OccupyPolicy _OccupyTy = Occupy::Fast>
+			_NODISCARD void* occupy(size_t bytes, size_t alignment = alignof(std::max_align_t), _OccupyTy = {}) noexcept
+			{
+				if (!std::has_single_bit(alignment))
+					return nullptr;
+
+				return occupiers<_OccupyTy>[class_of(bytes, alignment)](*this, bytes, alignment);
+			}
+
+			bool release(void* ptr, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept {
+				return releasers[class_of(bytes, alignment)](*this, ptr, bytes, alignment);
+			}
+
+			template <class _Ty, Detail::OccupyPolicy _OccupyTy = Occupy::Fast>
+			_NODISCARD _Ty* occupy(size_t count, _OccupyTy = {}) noexcept
+			{
+				if (count > std::numeric_limits<size_t>::max() / sizeof(_Ty))
+					return nullptr;
+
+				return static_cast<_Ty*>(occupy(sizeof(_Ty) * count, alignof(_Ty), _OccupyTy{}));
+			}
+
+			template <class _Ty>
+			bool release(_Ty* ptr, size_t count) noexcept {
+				return release(ptr, sizeof(_Ty) * count, alignof(_Ty));
+			}
+
+			template <size_t _Index>
+			_NODISCARD pool_at<_Index>& pool() noexcept {
+				return std::get<_Index>(myPools);
+			}
+
+		private:
+			pools_type myPools;
+		};
+	}
+}
+
+#endif
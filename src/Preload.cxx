@@ -0,0 +1,270 @@
+#include <SizeClassPool.hxx>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <malloc.h>
+
+extern "C"
+{
+	void* __libc_memalign(size_t alignment, size_t size);
+	void  __libc_free(void* data);
+}
+
+namespace
+{
+	template <class _Ty>
+	class LibcAllocator
+	{
+	public:
+		using value_type = _Ty;
+
+		constexpr LibcAllocator() noexcept = default;
+
+		template <class _OtherTy>
+		constexpr LibcAllocator(LibcAllocator<_OtherTy> const&) noexcept {}
+
+		_NODISCARD _Ty* allocate(size_t count)
+		{
+			if (count > std::numeric_limits<size_t>::max() / sizeof(_Ty))
+				throw std::bad_array_new_length{};
+
+			auto const data = __libc_memalign(std::max(alignof(_Ty), alignof(std::max_align_t)), sizeof(_Ty) * count);
+
+			if (data == nullptr)
+				throw std::bad_alloc{};
+
+			return static_cast<_Ty*>(data);
+		}
+
+		void deallocate(_Ty* data, size_t) noexcept {
+			__libc_free(data);
+		}
+
+		template <class _OtherTy>
+		_NODISCARD constexpr bool operator==(LibcAllocator<_OtherTy> const&) const noexcept {
+			return true;
+		}
+	};
+
+	// No replenisher thread runs inside the host process, and a bounded search that misses falls back to libc
+	using pools_type = Seweex::Memory::SizeClassPool<8, LibcAllocator<std::byte>, Seweex::Memory::Threading::Inline>;
+
+	enum class Origin : uint32_t {
+		pool = 0x6C6F6F70,
+		libc = 0x6362696C
+	};
+
+	struct Header final
+	{
+		size_t	 total;
+		uint32_t offset;
+		Origin	 origin;
+	};
+
+	constexpr size_t header_size = 16;
+	static_assert(sizeof(Header) == header_size);
+
+	[[gnu::tls_model("initial-exec")]] thread_local bool inside = false;
+
+	class Reentry final
+	{
+	public:
+		Reentry() noexcept :
+			myOuter (!inside)
+		{
+			inside = true;
+		}
+
+		~Reentry() noexcept {
+			if (myOuter)
+				inside = false;
+		}
+
+		Reentry(Reentry const&) = delete;
+		Reentry& operator=(Reentry const&) = delete;
+
+		_NODISCARD bool outer() const noexcept {
+			return myOuter;
+		}
+
+	private:
+		bool myOuter;
+	};
+
+	_NODISCARD pools_type& pools() noexcept
+	{
+		alignas(pools_type) static unsigned char storage[sizeof(pools_type)];
+		static auto const instance = new (storage) pools_type;
+
+		return *instance;
+	}
+
+	_NODISCARD Header& header_of(void* data) noexcept {
+		return *reinterpret_cast<Header*>(static_cast<unsigned char*>(data) - header_size);
+	}
+
+	_NODISCARD void* allocate(size_t size, size_t alignment) noexcept
+	{
+		alignment = std::max(alignment, header_size);
+
+		if (alignment > std::numeric_limits<uint32_t>::max()) {
+			errno = EINVAL;
+			return nullptr;
+		}
+
+		if (size > std::numeric_limits<size_t>::max() - alignment) {
+			errno = ENOMEM;
+			return nullptr;
+		}
+
+		auto const total = size + alignment;
+		auto	   origin = Origin::pool;
+		void*	   block  = nullptr;
+
+		if (Reentry reentry; reentry.outer())
+			block = pools().occupy(total, header_size, Seweex::Memory::Occupy::Bounded<>{});
+
+		if (block == nullptr) {
+			origin = Origin::libc;
+			block  = __libc_memalign(header_size, total);
+		}
+
+		if (block == nullptr) {
+			errno = ENOMEM;
+			return nullptr;
+		}
+
+		auto const begin = reinterpret_cast<uintptr_t>(block);
+		auto const data  = reinterpret_cast<void*>((begin + header_size + alignment - 1) & ~(alignment - 1));
+
+		header_of(data) = { total, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(data) - begin), origin };
+		return data;
+	}
+
+	void deallocate(void* data) noexcept
+	{
+		if (data == nullptr)
+			return;
+
+		auto const header = header_of(data);
+		auto const block  = static_cast<unsigned char*>(data) - header.offset;
+
+		switch (header.origin)
+		{
+		case Origin::pool: {
+			Reentry reentry;
+			pools().release(block, header.total, header_size);
+			break;
+		}
+
+		case Origin::libc:
+			__libc_free(block);
+			break;
+		}
+	}
+
+	_NODISCARD size_t usable_size(void* data) noexcept 
+	{
+		if (data == nullptr)
+			return 0;
+
+		auto const& header = header_of(data);
+		return header.total - header.offset;
+	}
+}
+
+extern "C"
+{
+	[[gnu::visibility("default")]] void* malloc(size_t size) noexcept {
+		return allocate(size, alignof(std::max_align_t));
+	}
+
+	[[gnu::visibility("default")]] void free(void* data) noexcept {
+		deallocate(data);
+	}
+
+	[[gnu::visibility("default")]] void* calloc(size_t count, size_t size) noexcept
+	{
+		if (size != 0 && count > std::numeric_limits<size_t>::max() / size) {
+			errno = ENOMEM;
+			return nullptr;
+		}
+
+		auto const data = allocate(count * size, alignof(std::max_align_t));
+
+		if (data != nullptr)
+			std::memset(data, 0, count * size);
+
+		return data;
+	}
+
+	[[gnu::visibility("default")]] void* realloc(void* data, size_t size) noexcept
+	{
+		if (data == nullptr)
+			return allocate(size, alignof(std::max_align_t));
+
+		if (size == 0) {
+			deallocate(data);
+			return nullptr;
+		}
+
+		auto const available = usable_size(data);
+
+		if (size <= available && size >= available / 2)
+			return data;
+
+		auto const moved = allocate(size, alignof(std::max_align_t));
+
+		if (moved != nullptr) {
+			std::memcpy(moved, data, std::min(size, available));
+			deallocate(data);
+		}
+
+		return moved;
+	}
+
+	[[gnu::visibility("default")]] int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+	{
+		if (!std::has_single_bit(alignment) || alignment % sizeof(void*) != 0)
+			return EINVAL;
+
+		auto const data = allocate(size, alignment);
+
+		if (data == nullptr)
+			return ENOMEM;
+
+		*result = data;
+		return 0;
+	}
+
+	[[gnu::visibility("default")]] void* aligned_alloc(size_t alignment, size_t size) noexcept
+	{
+		if (!std::has_single_bit(alignment)) {
+			errno = EINVAL;
+			return nullptr;
+		}
+
+		return allocate(size, alignment);
+	}
+
+	[[gnu::visibility("default")]] void* memalign(size_t alignment, size_t size) noexcept {
+		return aligned_alloc(std::bit_ceil(std::max<size_t>(alignment, 1)), size);
+	}
+
+	[[gnu::visibility("default")]] void* valloc(size_t size) noexcept {
+		return allocate(size, Seweex::Detail::system_page_size());
+	}
+
+	[[gnu::visibility("default")]] void* pvalloc(size_t size) noexcept
+	{
+		auto const pageSize = Seweex::Detail::system_page_size();
+		return allocate((size + pageSize - 1) & ~(pageSize - 1), pageSize);
+	}
+
+	[[gnu::visibility("default")]] size_t malloc_usable_size(void* data) noexcept {
+		return usable_size(data);
+	}
+}
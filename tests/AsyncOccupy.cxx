@@ -0,0 +1,177 @@
+#include "Check.hxx"
+#include "AsyncOccupy.hxx"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Seweex::Memory;
+using namespace std::chrono_literals;
+
+namespace
+{
+	using TestPool = Pool<4096, 16>;
+
+	// Runs eagerly and frees itself, the result and completion go through the arguments
+	struct Task final
+	{
+		struct promise_type final
+		{
+			_NODISCARD Task get_return_object() noexcept {
+				return {};
+			}
+
+			_NODISCARD std::suspend_never initial_suspend() noexcept {
+				return {};
+			}
+
+			_NODISCARD std::suspend_never final_suspend() noexcept {
+				return {};
+			}
+
+			void return_void() noexcept {}
+
+			void unhandled_exception() noexcept {
+				std::terminate();
+			}
+		};
+	};
+
+	struct Outcome final
+	{
+		void*			  result = reinterpret_cast<void*>(1);
+		std::atomic<bool> done	 = false;
+
+		_NODISCARD bool wait_for(std::chrono::steady_clock::duration timeout) const
+		{
+			auto const deadline = std::chrono::steady_clock::now() + timeout;
+
+			while (!done.load() && std::chrono::steady_clock::now() < deadline)
+				std::this_thread::sleep_for(1ms);
+
+			return done.load();
+		}
+	};
+
+	// Far more than any page allocator serves, the waiter stays queued until something else ends it
+	inline constexpr size_t unsatisfiable = size_t{ 1 } << 62;
+
+	template <class _PoolTy>
+	Task occupy_bytes(_PoolTy& pool, size_t bytes, std::stop_token token, std::chrono::steady_clock::time_point deadline, Outcome& outcome)
+	{
+		outcome.result = co_await async_occupy_bytes(pool, bytes, 16, std::move(token), deadline);
+		outcome.done   = true;
+	}
+
+	Task occupy_ints(TestPool& pool, size_t count, Outcome& outcome)
+	{
+		outcome.result = co_await async_occupy<int>(pool, count);
+		outcome.done   = true;
+	}
+
+	constexpr auto never = std::chrono::steady_clock::time_point::max();
+}
+
+SWX_TEST(async, immediate)
+{
+	TestPool pool;
+	Outcome outcome;
+
+	occupy_ints(pool, 500, outcome);
+
+	SWX_CHECK(outcome.wait_for(5s));
+	SWX_CHECK(outcome.result != nullptr);
+	SWX_CHECK(pool.release(static_cast<int*>(outcome.result), 500));
+}
+
+SWX_TEST(async, cancel)
+{
+	TestPool pool;
+	Outcome outcome;
+	std::stop_source source;
+
+	occupy_bytes(pool, unsatisfiable, source.get_token(), never, outcome);
+
+	std::this_thread::sleep_for(20ms);
+	SWX_CHECK(!outcome.done);
+
+	// The stop callback resumes the waiter on the cancelling thread
+	source.request_stop();
+
+	SWX_CHECK(outcome.done);
+	SWX_CHECK(outcome.result == nullptr);
+}
+
+SWX_TEST(async, stopped)
+{
+	TestPool pool;
+	Outcome outcome;
+	std::stop_source source;
+
+	source.request_stop();
+	occupy_bytes(pool, 64, source.get_token(), never, outcome);
+
+	SWX_CHECK(outcome.done);
+	SWX_CHECK(outcome.result == nullptr);
+}
+
+SWX_TEST(async, deadline)
+{
+	TestPool pool;
+	Outcome outcome;
+
+	auto const started = std::chrono::steady_clock::now();
+	occupy_bytes(pool, unsatisfiable, {}, started + 50ms, outcome);
+
+	SWX_CHECK(outcome.wait_for(5s));
+	SWX_CHECK(outcome.result == nullptr);
+	SWX_CHECK(std::chrono::steady_clock::now() - started >= 50ms);
+}
+
+SWX_TEST(async, overflow)
+{
+	TestPool pool;
+	Outcome outcome;
+
+	occupy_ints(pool, std::numeric_limits<size_t>::max(), outcome);
+
+	SWX_CHECK(outcome.done);
+	SWX_CHECK(outcome.result == nullptr);
+}
+
+// A persistent pool cannot grow past its file, so the waiter is served by the release that frees a page
+SWX_TEST(async, released)
+{
+	Seweex::Tests::TempFile const file{ "async" };
+	TestPool pool{ file.path(), 1 };
+	std::vector<std::byte*> pages;
+
+	while (auto const page = pool.occupy<std::byte>(TestPool::page_size, Occupy::Guaranteed{}))
+		pages.push_back(page);
+
+	SWX_CHECK(pages.size() == TestPool::chunk_pages);
+
+	if (pages.empty())
+		return;
+
+	Outcome outcome;
+	occupy_bytes(pool, TestPool::page_size, {}, never, outcome);
+
+	std::this_thread::sleep_for(20ms);
+	SWX_CHECK(!outcome.done);
+
+	SWX_CHECK(pool.release(pages.back(), TestPool::page_size));
+	pages.pop_back();
+
+	SWX_CHECK(outcome.wait_for(5s));
+	SWX_CHECK(outcome.result != nullptr);
+
+	if (outcome.result != nullptr)
+		pages.push_back(static_cast<std::byte*>(outcome.result));
+
+	for (auto const page : pages)
+		SWX_CHECK(pool.release(page, TestPool::page_size));
+
+	SWX_CHECK(pool.stats().occupied_bytes == 0);
+}
@@ -0,0 +1,94 @@
+#ifndef SEWEEX_MEMORY_TESTS_CHECK
+#define SEWEEX_MEMORY_TESTS_CHECK
+
+#include "Memory.hxx"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include <unistd.h>
+
+namespace Seweex
+{
+	namespace Tests
+	{
+		struct Case final
+		{
+			char const* suite;
+			char const* name;
+			void		(*run) ();
+		};
+
+		_NODISCARD inline std::vector<Case>& cases()
+		{
+			static std::vector<Case> all;
+			return all;
+		}
+
+		_NODISCARD inline std::atomic<size_t>& failures() noexcept
+		{
+			static std::atomic<size_t> count = 0;
+			return count;
+		}
+
+		struct Registrar final
+		{
+			Registrar (char const* suite, char const* name, void (*run) ()) {
+				cases().push_back({ suite, name, run });
+			}
+		};
+
+		// A file of its own per case and process, removed whatever the case leaves behind
+		class TempFile final
+		{
+		public:
+			TempFile (char const* name) :
+				myPath (std::filesystem::temp_directory_path() / ("swx-mempool-" + std::to_string(getpid()) + "-" + name))
+			{
+				std::filesystem::remove(myPath);
+			}
+
+			TempFile(TempFile&&)	  = delete;
+			TempFile(TempFile const&) = delete;
+
+			TempFile& operator=(TempFile&&)		 = delete;
+			TempFile& operator=(TempFile const&) = delete;
+
+			~TempFile() noexcept {
+				std::error_code ignored;
+				std::filesystem::remove(myPath, ignored);
+			}
+
+			_NODISCARD std::filesystem::path const& path() const noexcept {
+				return myPath;
+			}
+
+			_NODISCARD size_t size() const {
+				return std::filesystem::file_size(myPath);
+			}
+
+		private:
+			std::filesystem::path myPath;
+		};
+
+		// Checks run in release builds too and keep going, so one run reports every failure
+		inline void fail(char const* expression, char const* file, int line) noexcept
+		{
+			failures().fetch_add(1);
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+		}
+	}
+}
+
+#define SWX_TEST(suite, name)																		  \
+	static void suite##_##name();																	  \
+	static ::Seweex::Tests::Registrar const suite##_##name##_registrar{ #suite, #name, &suite##_##name }; \
+	static void suite##_##name()
+
+#define SWX_CHECK(...) \
+	do { if (!(__VA_ARGS__)) ::Seweex::Tests::fail(#__VA_ARGS__, __FILE__, __LINE__); } while (false)
+
+#endif
@@ -0,0 +1,40 @@
+#include "Check.hxx"
+
+#include <string_view>
+#include <exception>
+
+// Runs every case, or only those of the suite named by the first argument
+int main(int argc, char** argv)
+{
+	using namespace Seweex::Tests;
+
+	std::string_view const suite = argc > 1 ? argv[1] : "";
+	size_t ran = 0;
+
+	for (auto const& test : cases())
+	{
+		if (!suite.empty() && suite != test.suite)
+			continue;
+
+		std::printf("[ RUN  ] %s.%s\n", test.suite, test.name);
+		std::fflush(stdout);
+
+		auto const before = failures().load();
+
+		try {
+			test.run();
+		}
+		catch (std::exception const& error) {
+			fail(error.what(), test.suite, 0);
+		}
+		catch (...) {
+			fail("unknown exception", test.suite, 0);
+		}
+
+		std::printf("[ %s ] %s.%s\n", failures().load() == before ? " OK " : "FAIL", test.suite, test.name);
+		++ran;
+	}
+
+	std::printf("%zu cases, %zu failed checks\n", ran, failures().load());
+	return ran != 0 && failures().load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+#include "Check.hxx"
+
+#include <string>
+#include <fstream>
+#include <cstddef>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Seweex::Memory;
+using Seweex::Tests::TempFile;
+
+namespace
+{
+	using TestPool = Pool<4096, 16, std::allocator<Page<4096, 16>>, Threading::Inline>;
+
+	struct Node final
+	{
+		Node* next;
+		long  value;
+	};
+
+	_NODISCARD Node* fill_list(TestPool& pool, long count)
+	{
+		Node* head = nullptr;
+
+		for (long value = 0; value < count; ++value)
+		{
+			auto const node = pool.occupy<Node>(1, Occupy::Guaranteed{});
+
+			if (node == nullptr)
+				return nullptr;
+
+			*node = { head, value };
+			head  = node;
+		}
+
+		return head;
+	}
+
+	_NODISCARD bool holds_list(Node const* head, long count, ptrdiff_t relocation) noexcept
+	{
+		auto const moved = [relocation] (Node const* node) noexcept {
+			return reinterpret_cast<Node const*>(reinterpret_cast<std::byte const*>(node) + relocation);
+		};
+
+		for (auto node = head; node != nullptr; node = node->next ? moved(node->next) : nullptr)
+			if (node->value != --count)
+				return false;
+
+		return count == 0;
+	}
+
+	template <class _CallTy>
+	_NODISCARD std::error_code thrown_by(_CallTy&& call)
+	{
+		try {
+			call();
+		}
+		catch (std::system_error const& error) {
+			return error.code();
+		}
+
+		return {};
+	}
+}
+
+SWX_TEST(persistent, reopen)
+{
+	TempFile file{ "reopen" };
+	size_t occupied = 0;
+
+	{
+		TestPool pool{ file.path(), 5000 };
+
+		SWX_CHECK(pool.root() == nullptr);
+		SWX_CHECK(pool.relocation() == 0);
+
+		auto const head = fill_list(pool, 20000);
+
+		SWX_CHECK(head != nullptr);
+		pool.root(head);
+
+		occupied = pool.stats().occupied_bytes;
+	}
+
+	{
+		TestPool pool{ file.path(), 0 };
+
+		SWX_CHECK(pool.root() != nullptr);
+		SWX_CHECK(pool.stats().occupied_bytes == occupied);
+		SWX_CHECK(holds_list(static_cast<Node const*>(pool.root()), 20000, pool.relocation()));
+
+		// Pages of the adopted file serve new occupations and take back the old blocks
+		auto const extra = pool.occupy<Node>(1, Occupy::Guaranteed{});
+
+		SWX_CHECK(extra != nullptr);
+		SWX_CHECK(pool.release(extra, 1));
+		SWX_CHECK(pool.release(static_cast<Node*>(pool.root()), 1));
+		SWX_CHECK(pool.stats().occupied_bytes == occupied - sizeof(Node));
+	}
+}
+
+SWX_TEST(persistent, exclusive)
+{
+	TempFile file{ "exclusive" };
+	TestPool pool{ file.path(), 100 };
+
+	SWX_CHECK(thrown_by([&file] { TestPool second{ file.path(), 100 }; }) != std::error_code{});
+}
+
+SWX_TEST(persistent, mismatched)
+{
+	TempFile file{ "mismatched" };
+
+	{
+		TestPool pool{ file.path(), 100 };
+		pool.root(fill_list(pool, 100));
+	}
+
+	auto const size = file.size();
+
+	auto const code = thrown_by([&file] {
+		Pool<8192, 16, std::allocator<Page<8192, 16>>, Threading::Inline> other{ file.path(), 100, Recovery::discard };
+	});
+
+	SWX_CHECK(code == std::errc::invalid_argument);
+	SWX_CHECK(file.size() == size);
+
+	TestPool pool{ file.path(), 0 };
+
+	SWX_CHECK(holds_list(static_cast<Node const*>(pool.root()), 100, pool.relocation()));
+}
+
+SWX_TEST(persistent, foreign)
+{
+	TempFile file{ "foreign" };
+	std::string const content = "not a pool, and it must stay that way\n";
+
+	std::ofstream{ file.path() } << content;
+
+	SWX_CHECK(thrown_by([&file] { TestPool pool{ file.path(), 100, Recovery::discard }; }) == std::errc::invalid_argument);
+	SWX_CHECK(file.size() == content.size());
+
+	std::string read;
+	std::getline(std::ifstream{ file.path() }, read);
+
+	SWX_CHECK(read + '\n' == content);
+}
+
+SWX_TEST(persistent, unclean)
+{
+	TempFile file{ "unclean" };
+
+	{
+		TestPool pool{ file.path(), 100 };
+		pool.root(fill_list(pool, 100));
+	}
+
+	{
+		// What a crash leaves behind, the pool marks the file clean only when it closes
+		auto const descriptor = ::open(file.path().c_str(), O_WRONLY);
+		uint64_t const clean  = 0;
+
+		SWX_CHECK(descriptor >= 0);
+		SWX_CHECK(::pwrite(descriptor, &clean, sizeof(clean), offsetof(Seweex::Detail::PersistentHeader, clean)) == sizeof(clean));
+
+		::close(descriptor);
+	}
+
+	auto const size = file.size();
+
+	SWX_CHECK(thrown_by([&file] { TestPool pool{ file.path(), 100 }; }) == std::errc::state_not_recoverable);
+	SWX_CHECK(file.size() == size);
+
+	{
+		TestPool pool{ file.path(), 100, Recovery::discard };
+
+		SWX_CHECK(pool.root() == nullptr);
+		SWX_CHECK(pool.stats().occupied_bytes == 0);
+		SWX_CHECK(fill_list(pool, 10) != nullptr);
+	}
+
+	TestPool pool{ file.path(), 0 };
+	SWX_CHECK(pool.stats().occupied_bytes == 10 * sizeof(Node));
+}
+
+SWX_TEST(persistent, capacity)
+{
+	TempFile file{ "capacity" };
+	TestPool pool{ file.path(), 1 };
+	size_t pages = 0;
+
+	while (pool.occupy<std::byte>(TestPool::page_size, Occupy::Guaranteed{}) != nullptr)
+		++pages;
+
+	SWX_CHECK(pages == TestPool::chunk_pages);
+	SWX_CHECK(pool.stats().chunks == 1);
+	SWX_CHECK(pool.stats().occupied_bytes == pages * TestPool::page_size);
+}
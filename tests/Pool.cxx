@@ -0,0 +1,219 @@
+#include "Check.hxx"
+
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+using namespace Seweex::Memory;
+
+namespace
+{
+	template <class _ThreadingTy>
+	using TestPool = Pool<4096, 16, std::allocator<Page<4096, 16>>, _ThreadingTy>;
+
+	// Larger than a page, so these go to dedicated mappings
+	inline constexpr size_t large_count = 1500;
+
+	struct Block final
+	{
+		uint32_t* data;
+		size_t	  count;
+		uint32_t  tag;
+	};
+
+	// A fast occupation leaves growth to the replenisher, so it may miss until the replenisher catches up
+	template <class _ThreadingTy, class _OccupyTy, class _CallTy>
+	_NODISCARD uint32_t* retrying(_CallTy&& call)
+	{
+		constexpr bool may_miss = _OccupyTy::growths == 0 && _ThreadingTy::replenishing;
+
+		auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 5 };
+		auto	   result	= call();
+
+		if constexpr (may_miss)
+			while (result == nullptr && std::chrono::steady_clock::now() < deadline) {
+				std::this_thread::yield();
+				result = call();
+			}
+
+		return result;
+	}
+
+	_NODISCARD bool holds(Block const& block, size_t count) noexcept {
+		return std::all_of(block.data, block.data + count, [&block] (uint32_t value) { return value == block.tag; });
+	}
+
+	template <class _ThreadingTy, class _OccupyTy>
+	void churn(TestPool<_ThreadingTy>& pool, unsigned seed, size_t steps)
+	{
+		std::mt19937 random{ seed };
+		std::vector<Block> blocks;
+
+		auto const pick_count = [&random] {
+			return random() % 16 == 0 ? large_count + random() % 500 : 1 + random() % 200;
+		};
+
+		for (size_t step = 0; step < steps; ++step)
+		{
+			auto const action = random() % 3;
+
+			if (blocks.size() < 32 || action == 0)
+			{
+				auto const count = pick_count();
+				auto const data	 = retrying<_ThreadingTy, _OccupyTy>([&] { return pool.template occupy<uint32_t>(count, _OccupyTy{}); });
+
+				SWX_CHECK(data != nullptr);
+				SWX_CHECK(reinterpret_cast<uintptr_t>(data) % TestPool<_ThreadingTy>::page_alignment == 0);
+
+				if (data == nullptr)
+					continue;
+
+				blocks.push_back({ data, count, static_cast<uint32_t>(random()) });
+				std::fill_n(data, count, blocks.back().tag);
+			}
+			else if (action == 1)
+			{
+				auto const index = random() % blocks.size();
+				auto const block = blocks[index];
+
+				SWX_CHECK(holds(block, block.count));
+				SWX_CHECK(pool.release(block.data, block.count));
+
+				blocks[index] = blocks.back();
+				blocks.pop_back();
+			}
+			else
+			{
+				auto&	   block = blocks[random() % blocks.size()];
+				auto const count = pick_count();
+				auto const data	 = retrying<_ThreadingTy, _OccupyTy>([&] { return pool.reallocate(block.data, block.count, count, _OccupyTy{}); });
+
+				SWX_CHECK(data != nullptr);
+
+				if (data == nullptr)
+					continue;
+
+				block.data = data;
+				SWX_CHECK(holds(block, std::min(block.count, count)));
+
+				block.count = count;
+				std::fill_n(block.data, block.count, block.tag);
+			}
+		}
+
+		for (auto const& block : blocks) {
+			SWX_CHECK(holds(block, block.count));
+			SWX_CHECK(pool.release(block.data, block.count));
+		}
+	}
+
+	template <class _ThreadingTy, class _OccupyTy>
+	void exercise(size_t threads)
+	{
+		TestPool<_ThreadingTy> pool;
+
+		// Without a replenisher every policy may grow at least once, so the first attempt must succeed
+		if constexpr (_OccupyTy::growths != 0 || !_ThreadingTy::replenishing) {
+			auto const first = pool.template occupy<uint32_t>(100, _OccupyTy{});
+
+			SWX_CHECK(first != nullptr);
+			SWX_CHECK(pool.release(first, 100));
+		}
+
+		if (threads == 1)
+			churn<_ThreadingTy, _OccupyTy>(pool, 1, 4000);
+		else
+		{
+			std::vector<std::jthread> workers;
+
+			for (unsigned seed = 0; seed < threads; ++seed)
+				workers.emplace_back([&pool, seed] { churn<_ThreadingTy, _OccupyTy>(pool, seed + 1, 2000); });
+		}
+
+		auto const stats = pool.stats();
+
+		SWX_CHECK(stats.occupied_bytes == 0);
+		SWX_CHECK(stats.large_allocations == 0);
+		SWX_CHECK(stats.large_bytes == 0);
+	}
+
+	template <class _ThreadingTy>
+	void exercise_policies(size_t threads)
+	{
+		exercise<_ThreadingTy, Occupy::Fast>(threads);
+		exercise<_ThreadingTy, Occupy::Guaranteed>(threads);
+		exercise<_ThreadingTy, Occupy::Bounded<>>(threads);
+		exercise<_ThreadingTy, Occupy::Bounded<1>>(threads);
+	}
+}
+
+SWX_TEST(pool, single)   { exercise_policies<Threading::Single>(1); }
+SWX_TEST(pool, blocking) { exercise_policies<Threading::Blocking>(1); }
+SWX_TEST(pool, spinning) { exercise_policies<Threading::Spinning>(1); }
+SWX_TEST(pool, inline)   { exercise_policies<Threading::Inline>(1); }
+
+SWX_TEST(pool, blocking_threads) { exercise_policies<Threading::Blocking>(4); }
+SWX_TEST(pool, spinning_threads) { exercise_policies<Threading::Spinning>(4); }
+SWX_TEST(pool, inline_threads)	 { exercise_policies<Threading::Inline>(4); }
+
+SWX_TEST(pool, aligned_bytes)
+{
+	TestPool<Threading::Inline> pool;
+
+	for (size_t alignment : { 16, 64, 256, 4096, 8192 })
+		for (size_t bytes : { 1, 100, 3000, 10000 })
+		{
+			auto const data = pool.occupy_bytes(bytes, alignment, Occupy::Guaranteed{});
+
+			SWX_CHECK(data != nullptr);
+			SWX_CHECK(reinterpret_cast<uintptr_t>(data) % alignment == 0);
+
+			std::fill_n(static_cast<std::byte*>(data), bytes, std::byte{ 0x5A });
+			SWX_CHECK(pool.release_bytes(data, bytes, alignment));
+		}
+
+	SWX_CHECK(pool.occupy_bytes(64, 3) == nullptr);
+	SWX_CHECK(pool.stats().occupied_bytes == 0);
+	SWX_CHECK(pool.stats().large_allocations == 0);
+}
+
+SWX_TEST(pool, release_batch)
+{
+	TestPool<Threading::Inline> pool;
+	std::vector<std::pair<void*, size_t>> blocks;
+
+	for (size_t index = 0; index < 200; ++index)
+	{
+		auto const bytes = index % 50 == 0 ? size_t{ 8192 } : 16 * (1 + index % 20);
+		blocks.emplace_back(pool.occupy<std::byte>(bytes, Occupy::Guaranteed{}), bytes);
+
+		SWX_CHECK(blocks.back().first != nullptr);
+	}
+
+	std::sort(blocks.begin(), blocks.end());
+	blocks.emplace_back(nullptr, 16);
+
+	SWX_CHECK(pool.release_batch(blocks) == 200);
+	SWX_CHECK(pool.stats().occupied_bytes == 0);
+	SWX_CHECK(pool.stats().large_allocations == 0);
+}
+
+SWX_TEST(pool, trim)
+{
+	TestPool<Threading::Single> pool;
+	std::vector<uint32_t*> blocks;
+
+	for (size_t index = 0; index < 5000; ++index)
+		blocks.push_back(pool.occupy<uint32_t>(1000, Occupy::Guaranteed{}));
+
+	SWX_CHECK(std::find(blocks.begin(), blocks.end(), nullptr) == blocks.end());
+	SWX_CHECK(pool.stats().chunks > 1);
+
+	for (auto const block : blocks)
+		SWX_CHECK(pool.release(block, 1000));
+
+	SWX_CHECK(pool.trim() != 0);
+	SWX_CHECK(pool.stats().occupied_bytes == 0);
+}
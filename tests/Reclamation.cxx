@@ -0,0 +1,151 @@
+#include "Check.hxx"
+#include "Reclamation.hxx"
+
+#include <latch>
+#include <thread>
+#include <vector>
+
+using namespace Seweex::Memory;
+
+namespace
+{
+	using TestPool = Pool<4096, 16>;
+
+	std::atomic<size_t> destroyed = 0;
+
+	struct Tracked final
+	{
+		long value = 0;
+
+		~Tracked() noexcept {
+			destroyed.fetch_add(1);
+		}
+	};
+
+	struct Node final
+	{
+		static constexpr unsigned live = 0xA11CE;
+		static constexpr unsigned dead = 0xDEAD;
+
+		std::atomic<Node*> next  = nullptr;
+		unsigned		   magic = live;
+
+		~Node() noexcept {
+			magic = dead;
+		}
+	};
+}
+
+SWX_TEST(reclamation, pinned)
+{
+	TestPool pool;
+
+	{
+		EpochDomain<TestPool> domain{ pool };
+
+		std::latch pinned{ 1 };
+		std::latch unpin{ 1 };
+
+		std::jthread reader{ [&] {
+			auto participant = domain.attach();
+			auto guard		 = participant.pin();
+
+			pinned.count_down();
+			unpin.wait();
+		} };
+
+		pinned.wait();
+
+		auto participant = domain.attach();
+		auto const value	= std::construct_at(pool.occupy<Tracked>(1, Occupy::Guaranteed{}));
+		auto const occupied = pool.stats().occupied_bytes;
+
+		destroyed = 0;
+		participant.retire(value);
+
+		// A pinned participant may still reach the block, so no number of flushes frees it
+		for (int attempt = 0; attempt < 8; ++attempt)
+			participant.flush();
+
+		SWX_CHECK(destroyed == 0);
+		SWX_CHECK(participant.pending() == 1);
+		SWX_CHECK(occupied != 0);
+		SWX_CHECK(pool.stats().occupied_bytes == occupied);
+
+		unpin.count_down();
+		reader.join();
+
+		for (int attempt = 0; attempt < 8 && participant.pending() != 0; ++attempt)
+			participant.flush();
+
+		SWX_CHECK(destroyed == 1);
+		SWX_CHECK(participant.pending() == 0);
+		SWX_CHECK(pool.stats().occupied_bytes == 0);
+	}
+}
+
+// A Treiber stack pops under a pin and retires what it popped, a reused node would fail the magic check
+SWX_TEST(reclamation, stack)
+{
+	TestPool pool;
+
+	{
+		EpochDomain<TestPool> domain{ pool };
+		std::atomic<Node*> head = nullptr;
+
+		{
+			std::vector<std::jthread> workers;
+
+			for (unsigned thread = 0; thread < 4; ++thread)
+				workers.emplace_back([&, thread]
+				{
+					auto participant = domain.attach();
+
+					for (unsigned step = 0; step < 20000; ++step)
+					{
+						if ((step + thread) % 2 == 0)
+						{
+							auto const node = std::construct_at(pool.occupy<Node>(1, Occupy::Guaranteed{}));
+							auto top = head.load();
+
+							do node->next.store(top);
+							while (!head.compare_exchange_weak(top, node));
+
+							continue;
+						}
+
+						Node* top = nullptr;
+
+						{
+							auto const guard = participant.pin();
+
+							for (top = head.load(std::memory_order_acquire); top != nullptr;)
+							{
+								SWX_CHECK(top->magic == Node::live);
+
+								if (head.compare_exchange_weak(top, top->next.load()))
+									break;
+							}
+						}
+
+						participant.retire(top);
+					}
+
+					participant.flush();
+				});
+		}
+
+		auto participant = domain.attach();
+
+		for (auto node = head.exchange(nullptr); node != nullptr;)
+			participant.retire(std::exchange(node, node->next.load()));
+
+		for (int attempt = 0; attempt < 8 && participant.pending() != 0; ++attempt)
+			participant.flush();
+
+		SWX_CHECK(participant.pending() == 0);
+	}
+
+	// Batches left by participants that went away are freed by the others or by the domain
+	SWX_CHECK(pool.stats().occupied_bytes == 0);
+}